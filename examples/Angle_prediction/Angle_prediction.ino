@@ -0,0 +1,49 @@
+#include <Tli493d.h>
+#include <util/Predictor.h>
+
+/**
+* This example runs a control loop at 5kHz while the sensor is read every millisecond. Between the samples the angle of a
+* rotating diametral magnet is extrapolated with velocity and acceleration, including the latency from the measurement
+* to the end of the read-out. The prediction can also be queried from a timer interrupt.
+*/
+
+#define SAMPLE_INTERVAL 1000    //us
+#define CONTROL_INTERVAL 200    //us
+#define LATENCY 300             //us, conversion and read-out
+
+//Voltage level LOW at pin 5 switches on the sensor VDD; Operating mode is FASTMODE
+Tli493d Tli493dMagnetic3DSensor = Tli493d(5, LOW, Tli493d::FASTMODE);
+
+tli493d::Predictor_t predictor;
+uint32_t lastSample = 0;
+uint32_t lastControl = 0;
+uint16_t count = 0;
+
+void setup() {
+  Serial.begin(115200);
+  while (!Serial);
+  Tli493dMagnetic3DSensor.begin(true);
+  Tli493dMagnetic3DSensor.disableTemp();
+  tli493d::initPredictor(&predictor, tli493d::PREDICT_QUADRATIC, LATENCY, 2 * SAMPLE_INTERVAL);
+}
+
+void loop() {
+  uint32_t now = micros();
+  if (now - lastSample >= SAMPLE_INTERVAL) {
+    lastSample = now;
+    if (Tli493dMagnetic3DSensor.updateData() == TLI493D_NO_ERROR)
+      tli493d::addToPredictor(&predictor, micros(), Tli493dMagnetic3DSensor.getRawX(),
+                              Tli493dMagnetic3DSensor.getRawY(), Tli493dMagnetic3DSensor.getRawZ());
+  }
+
+  now = micros();
+  if (now - lastControl >= CONTROL_INTERVAL) {
+    lastControl = now;
+    tli493d::Bam_t angle = tli493d::predictAngle(&predictor, now);
+    //control output would be computed here; print every 500th value
+    if (++count == 500) {
+      count = 0;
+      Serial.println(tli493d::bamToDegrees(angle));
+    }
+  }
+}
@@ -0,0 +1,55 @@
+#include <Tli493d.h>
+#include <Tli493dDiscovery.h>
+#include <Tli493dArray.h>
+
+/**
+* This example finds out which of the sensor types A0 to A3 are connected to the bus and which silicon version each
+* one has. Other devices on the address of a sensor are reported as conflict. The sensors found are then started
+* together and read out.
+*/
+
+Tli493dDiscovery discovery = Tli493dDiscovery(Tli493d::MASTERCONTROLLEDMODE);
+Tli493dArray *array;
+
+const Tli493d::TypeAddress_e types[] = {Tli493d::TLI493D_A0, Tli493d::TLI493D_A1, Tli493d::TLI493D_A2,
+                                        Tli493d::TLI493D_A3};
+
+void setup() {
+  Serial.begin(115200);
+  while (!Serial);
+
+  uint8_t count = discovery.discover(Wire, true);
+  Serial.print(count);
+  Serial.print(" sensors found with ");
+  Serial.print(discovery.getTransactions());
+  Serial.println(" transactions");
+  for (uint8_t i = 0; i < 4; i++) {
+    uint8_t conflicts = discovery.getConflicts(types[i]);
+    if (conflicts & TLI493D_CONFLICT_FOREIGN) {
+      Serial.print("Another device uses the address 0x");
+      Serial.println(types[i], HEX);
+    }
+    if (conflicts & TLI493D_CONFLICT_NO_READ) {
+      Serial.print("Address 0x");
+      Serial.print(types[i], HEX);
+      Serial.println(" is acknowledged, but cannot be read");
+    }
+  }
+  for (uint8_t i = 0; i < count; i++) {
+    Serial.print("Version 0x");
+    Serial.println(discovery.getVersion(i), HEX);
+  }
+
+  //the discovery has reset the bus already
+  array = new Tli493dArray(discovery.getSensors(), count);
+  array->begin(false);
+}
+
+void loop() {
+  for (uint8_t i = 0; i < array->getCount(); i++) {
+    (*array)[i].updateData();
+    Serial.print((*array)[i].getNorm());
+    Serial.print(i + 1 < array->getCount() ? "\t" : "\n");
+  }
+  delay(100);
+}
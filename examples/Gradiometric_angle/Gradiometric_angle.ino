@@ -0,0 +1,50 @@
+#include <Tli493d.h>
+#include <Tli493dPair.h>
+
+/**
+* This example measures the angle of a rotating diametral magnet with two sensors of the types A0 and A1 on the same bus.
+* The first sensor is placed under the magnet, the second one further away on the rotation axis. Homogeneous stray
+* fields, e.g. from a motor, are removed from the angle and reported if they exceed 2mT.
+* For calibration the magnet is turned without stray field, e.g. with the motor switched off.
+*/
+
+Tli493d first = Tli493d(Tli493d::MASTERCONTROLLEDMODE, Tli493d::TLI493D_A0);
+Tli493d second = Tli493d(Tli493d::MASTERCONTROLLEDMODE, Tli493d::TLI493D_A1);
+Tli493dPair pair = Tli493dPair(first, second);
+
+void setup() {
+  Serial.begin(115200);
+  while (!Serial);
+  //the reset is a general call and resets both sensors
+  first.begin(Wire, Tli493d::TLI493D_A0, true, 1);
+  second.begin(Wire, Tli493d::TLI493D_A1, false, 1);
+
+  Serial.println("Turn the magnet without stray field and send any character");
+  while (Serial.available() == 0);
+  while (Serial.available() > 0)
+    Serial.read();
+  if (!pair.calibrate(64)) {
+    Serial.println("Calibration failed: the field at the second sensor is too similar to the first one");
+    while (1);
+  }
+  Serial.print("Ratio: ");
+  Serial.println(pair.getRatio());
+  pair.setStrayFieldLimit(2.0);
+}
+
+void loop() {
+  if (pair.updateData() != TLI493D_NO_ERROR) {
+    Serial.println("Bus error");
+    delay(100);
+    return;
+  }
+  Serial.print(pair.getAzimuth() * 180 / PI);
+  Serial.print("\t");
+  Serial.print(pair.getStrayNorm());
+  Serial.print("\t");
+  Serial.print(pair.getSkew());
+  if (pair.strayFieldExceeded())
+    Serial.print("\tstray field exceeded");
+  Serial.println();
+  delay(100);
+}
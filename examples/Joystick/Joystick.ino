@@ -0,0 +1,49 @@
+#include <Tli493d.h>
+#include <util/Joystick.h>
+
+/**
+* This example demonstrates the use of the sensor as magnetic joystick. After a calibration of the centre and the extents,
+* Bx and By are mapped to positions in [-1024,1024] in integer math, with deadzone and linearisation of the tilt.
+*/
+
+//Voltage level LOW at pin 5 switches on the sensor VDD
+Tli493d Tli493dMagnetic3DSensor = Tli493d(5, LOW);
+
+tli493d::Joystick_t joystick;
+
+void setup() {
+  Serial.begin(115200);
+  while (!Serial);
+  Tli493dMagnetic3DSensor.begin(true);
+
+  tli493d::initJoystick(&joystick);
+  Serial.println("Release the joystick");
+  delay(1000);
+  for (uint8_t i = 0; i < 64; i++) {
+    Tli493dMagnetic3DSensor.updateData();
+    tli493d::addJoystickCenter(&joystick, Tli493dMagnetic3DSensor.getRawX(), Tli493dMagnetic3DSensor.getRawY());
+    delay(10);
+  }
+
+  Serial.println("Move the joystick along its border for 5 seconds");
+  uint32_t start = millis();
+  while (millis() - start < 5000) {
+    Tli493dMagnetic3DSensor.updateData();
+    tli493d::addJoystickExtent(&joystick, Tli493dMagnetic3DSensor.getRawX(), Tli493dMagnetic3DSensor.getRawY());
+  }
+
+  //round deadzone of 5%, the magnet tilts by up to 20 degree
+  if (!tli493d::finishJoystickCalibration(&joystick, 51, tli493d::DEADZONE_CIRCLE, 20.0))
+    Serial.println("Calibration failed");
+}
+
+void loop() {
+  int16_t x, y;
+  Tli493dMagnetic3DSensor.updateData();
+  tli493d::getJoystick(&joystick, Tli493dMagnetic3DSensor.getRawX(), Tli493dMagnetic3DSensor.getRawY(), &x, &y);
+
+  Serial.print(x);
+  Serial.print(" ; ");
+  Serial.println(y);
+  delay(50);
+}
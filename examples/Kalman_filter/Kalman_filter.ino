@@ -0,0 +1,83 @@
+#include <Tli493d.h>
+#include <util/Kalman.h>
+
+/**
+* This example filters Bx, By and Bz with a constant velocity Kalman filter in fixed point and prints the filtered field,
+* its rate and, for comparison, the float reference filter. The time of an update is measured at the start, and a slow
+* ramp checks the gains of long sample intervals.
+* The measurement noise of about 1 LSB can be taken from examples/Noise_capture.
+*/
+
+#define MEASUREMENT_NOISE 1.0     //LSB
+#define ACCELERATION_NOISE 1e5    //LSB/s^2
+#define GATE 5.0                  //standard deviations
+#define MAX_OUTLIERS 3
+
+//Voltage level LOW at pin 5 switches on the sensor VDD
+Tli493d Tli493dMagnetic3DSensor = Tli493d(5, LOW);
+
+tli493d::Kalman_t kalman;
+tli493d::KalmanReference_t reference;
+
+void setup() {
+  Serial.begin(115200);
+  while (!Serial);
+  Tli493dMagnetic3DSensor.begin(true);
+  tli493d::initKalman(&kalman, MEASUREMENT_NOISE, ACCELERATION_NOISE, GATE, MAX_OUTLIERS);
+  tli493d::initKalmanReference(&reference, MEASUREMENT_NOISE, ACCELERATION_NOISE);
+
+  Tli493dMagnetic3DSensor.updateData();
+  int16_t x = Tli493dMagnetic3DSensor.getRawX();
+  uint32_t start = micros();
+  for (uint16_t i = 0; i < 1000; i++)
+    tli493d::addToKalman(&kalman, i * 1000UL, x, 0, 0);
+  uint32_t fixedTime = micros() - start;
+  start = micros();
+  for (uint16_t i = 0; i < 1000; i++)
+    tli493d::addToKalmanReference(&reference, i * 1000UL, x, 0, 0);
+  uint32_t floatTime = micros() - start;
+  Serial.print("Update time fixed point: ");
+  Serial.print(fixedTime / 1000.0);
+  Serial.print(" us, float reference: ");
+  Serial.print(floatTime / 1000.0);
+  Serial.println(" us");
+
+  //a ramp of 1 LSB per 50ms uses the bins of the slow intervals (32ms and longer), it is tracked without outliers
+  tli493d::initKalman(&kalman, MEASUREMENT_NOISE, ACCELERATION_NOISE, GATE, MAX_OUTLIERS);
+  bool slowOk = true;
+  for (uint16_t i = 0; i < 100; i++)
+    slowOk &= tli493d::addToKalman(&kalman, i * 50000UL, x + i, 0, 0);
+  int16_t fx, fy, fz;
+  tli493d::getKalmanField(&kalman, &fx, &fy, &fz);
+  slowOk &= abs(fx - (x + 99)) <= 1;
+  Serial.println(slowOk ? "Slow interval check passed" : "Slow interval check FAILED");
+
+  tli493d::initKalman(&kalman, MEASUREMENT_NOISE, ACCELERATION_NOISE, GATE, MAX_OUTLIERS);
+  tli493d::initKalmanReference(&reference, MEASUREMENT_NOISE, ACCELERATION_NOISE);
+}
+
+void loop() {
+  Tli493dMagnetic3DSensor.updateData();
+  uint32_t now = micros();
+  int16_t x = Tli493dMagnetic3DSensor.getRawX();
+  int16_t y = Tli493dMagnetic3DSensor.getRawY();
+  int16_t z = Tli493dMagnetic3DSensor.getRawZ();
+  bool accepted = tli493d::addToKalman(&kalman, now, x, y, z);
+  tli493d::addToKalmanReference(&reference, now, x, y, z);
+
+  int16_t fx, fy, fz;
+  int32_t rx, ry, rz;
+  tli493d::getKalmanField(&kalman, &fx, &fy, &fz);
+  tli493d::getKalmanRate(&kalman, &rx, &ry, &rz);
+  Serial.print(x);
+  Serial.print("\t");
+  Serial.print(fx);
+  Serial.print("\t");
+  Serial.print(reference.field[0]);
+  Serial.print("\t");
+  Serial.print(rx);
+  Serial.print("\t");
+  Serial.print(reference.rate[0]);
+  Serial.println(accepted ? "" : "\toutlier");
+  delay(10);
+}
@@ -0,0 +1,89 @@
+#include <Tli493d.h>
+#include <util/Knob.h>
+
+/**
+* This example turns the field of a knob into events: 24 detents per revolution, push and tilt.
+* The knob carries a diametrically magnetised magnet above the sensor. The sensor measures in low power mode and only
+* sends an interrupt when the field leaves a window around the last value (tracking wake-up), so the microcontroller
+* can sleep while the knob is not touched.
+*/
+
+#define DETENTS 24
+#define HYSTERESIS 32       //1/8 detent
+#define PUSH 40             //LSB
+#define TILT 60             //LSB
+#define DEBOUNCE 2          //samples
+#define WAKEUP_DELTA 20     //LSB, smaller than the field change of one detent
+
+//Voltage level LOW at pin 5 switches on the sensor VDD; Operating mode is LOWPOWERMODE
+Tli493d Tli493dMagnetic3DSensor = Tli493d(5, LOW, Tli493d::LOWPOWERMODE);
+
+tli493d::Knob_t knob;
+volatile bool dataReady = false;
+
+void setup() {
+  Serial.begin(115200);
+  while (!Serial);
+  Tli493dMagnetic3DSensor.begin(true);
+  Tli493dMagnetic3DSensor.disableTemp();
+  Tli493dMagnetic3DSensor.setUpdateRate(2);
+
+  //the knob has to be at rest
+  Tli493dMagnetic3DSensor.updateData();
+  tli493d::initKnob(&knob, Tli493dMagnetic3DSensor.getRawX(), Tli493dMagnetic3DSensor.getRawY(),
+                    Tli493dMagnetic3DSensor.getRawZ(), DETENTS, HYSTERESIS, PUSH, TILT, DEBOUNCE);
+
+  //the window is recentred by every updateData()
+  Tli493dMagnetic3DSensor.enableWakeUpTracking(WAKEUP_DELTA);
+  Tli493dMagnetic3DSensor.updateData();
+  Tli493dMagnetic3DSensor.enableWakeUp();
+  Tli493dMagnetic3DSensor.enableInterrupt();
+
+  //sensor interrupt is connected to pin 9
+  pinMode(9, INPUT_PULLUP);
+  attachInterrupt(digitalPinToInterrupt(9), sensor_irq, FALLING);
+}
+
+void loop() {
+  if (!dataReady) {
+    //Microcontroller may sleep until interrupt
+    return;
+  }
+  dataReady = false;
+
+  Tli493dMagnetic3DSensor.updateData();
+  tli493d::addToKnob(&knob, Tli493dMagnetic3DSensor.getRawX(), Tli493dMagnetic3DSensor.getRawY(),
+                     Tli493dMagnetic3DSensor.getRawZ());
+
+  tli493d::KnobEvent_t event;
+  while (tli493d::getKnobEvent(&knob, &event)) {
+    switch (event.type) {
+      case tli493d::KNOB_DETENT:
+        Serial.print("Detent ");
+        Serial.println(event.position);
+        break;
+      case tli493d::KNOB_PUSH:
+        Serial.println("Push");
+        break;
+      case tli493d::KNOB_RELEASE:
+        Serial.println("Release");
+        break;
+      case tli493d::KNOB_TILT:
+        Serial.print("Tilt towards ");
+        Serial.println(tli493d::bamToDegrees((tli493d::Bam_t)event.value));
+        break;
+      case tli493d::KNOB_UNTILT:
+        Serial.println("Tilt released");
+        break;
+    }
+  }
+
+  //while pushed or tilted the field stays outside of the rest window, so keep polling
+  if (!tli493d::knobIdle(&knob))
+    dataReady = true;
+}
+
+//This function is called, when the sensor sends an interrupt-pulse.
+void sensor_irq() {
+  dataReady = true;
+}
@@ -0,0 +1,57 @@
+#include <Tli493d.h>
+#include <util/PositionLut.h>
+
+/**
+* This example demonstrates linear position sensing with a magnet on a slide moving along the x axis of the sensor.
+* The angle of Bx and Bz is recorded at known positions, the position is then interpolated from this lookup table.
+* The table is printed as source code, so it can be compiled into flash, and the time of a lookup is measured.
+*/
+
+#define POINTS 11
+#define STEP 100        //distance between the calibration points, e.g. in 0.01mm
+
+//Voltage level LOW at pin 5 switches on the sensor VDD
+Tli493d Tli493dMagnetic3DSensor = Tli493d(5, LOW);
+
+tli493d::PositionPoint_t points[POINTS];
+tli493d::PositionLut_t lut;
+
+void setup() {
+  Serial.begin(115200);
+  while (!Serial);
+  Tli493dMagnetic3DSensor.begin(true);
+
+  for (uint8_t i = 0; i < POINTS; i++) {
+    Serial.print("Move the slide to position ");
+    Serial.print(i * STEP);
+    Serial.println(" and send any character");
+    while (Serial.available() == 0);
+    while (Serial.available() > 0)
+      Serial.read();
+
+    Tli493dMagnetic3DSensor.updateData();
+    points[i].key = tli493d::getPositionKey(Tli493dMagnetic3DSensor.getRawX(), Tli493dMagnetic3DSensor.getRawZ());
+    points[i].position = i * STEP;
+  }
+
+  if (!tli493d::finishPositionLut(&lut, points, POINTS)) {
+    Serial.println("Calibration failed: position is not monotonic in the field angle");
+    while (1);
+  }
+  tli493d::printPositionLut(&lut, Serial);
+
+  uint32_t start = micros();
+  volatile int16_t position;
+  for (uint16_t i = 0; i < 1000; i++)
+    position = tli493d::getPosition(&lut, Tli493dMagnetic3DSensor.getRawX() + i, Tli493dMagnetic3DSensor.getRawZ());
+  (void)position;
+  Serial.print("Lookup time: ");
+  Serial.print((micros() - start) / 1000.0);
+  Serial.println(" us");
+}
+
+void loop() {
+  Tli493dMagnetic3DSensor.updateData();
+  Serial.println(tli493d::getPosition(&lut, Tli493dMagnetic3DSensor.getRawX(), Tli493dMagnetic3DSensor.getRawZ()));
+  delay(100);
+}
@@ -0,0 +1,60 @@
+#include <Tli493d.h>
+#include <util/Dipole.h>
+
+/**
+* This example estimates distance and direction of an axially magnetised magnet with the dipole model.
+* For calibration the magnet is placed above the sensor with its axis along the z axis of the sensor.
+* The model is only valid at distances of a few magnet diameters or more.
+*/
+
+#define CALIBRATION_DISTANCE 20.0   //in mm
+#define NOISE 0.13                  //noise of the field in mT, see examples/Noise_capture
+#define RANGE 160.0                 //measurable field in mT for the FULL range
+
+//Voltage level LOW at pin 5 switches on the sensor VDD
+Tli493d Tli493dMagnetic3DSensor = Tli493d(5, LOW);
+
+tli493d::Dipole_t dipole;
+
+void setup() {
+  Serial.begin(115200);
+  while (!Serial);
+  Tli493dMagnetic3DSensor.begin(true);
+
+  Serial.print("Place the magnet ");
+  Serial.print(CALIBRATION_DISTANCE);
+  Serial.println(" mm above the sensor and send any character");
+  while (Serial.available() == 0);
+  while (Serial.available() > 0)
+    Serial.read();
+
+  Tli493dMagnetic3DSensor.updateData();
+  tli493d::calibrateDipole(&dipole, Tli493dMagnetic3DSensor.getX(), Tli493dMagnetic3DSensor.getY(),
+                           Tli493dMagnetic3DSensor.getZ(), CALIBRATION_DISTANCE, NOISE, RANGE);
+
+  tli493d::DipoleEstimate_t estimate;
+  uint32_t start = micros();
+  for (uint16_t i = 0; i < 1000; i++)
+    tli493d::estimateDipole(&dipole, Tli493dMagnetic3DSensor.getX() + i * 0.01, Tli493dMagnetic3DSensor.getY(),
+                            Tli493dMagnetic3DSensor.getZ(), &estimate);
+  Serial.print("Estimation time: ");
+  Serial.print((micros() - start) / 1000.0);
+  Serial.println(" us");
+}
+
+void loop() {
+  tli493d::DipoleEstimate_t estimate;
+  Tli493dMagnetic3DSensor.updateData();
+  tli493d::estimateDipole(&dipole, Tli493dMagnetic3DSensor.getX(), Tli493dMagnetic3DSensor.getY(),
+                          Tli493dMagnetic3DSensor.getZ(), &estimate);
+
+  //position of the sensor relative to the magnet
+  Serial.print(estimate.distance);
+  Serial.print("\t");
+  for (uint8_t i = 0; i < 3; i++) {
+    Serial.print(estimate.distance * estimate.direction[i]);
+    Serial.print("\t");
+  }
+  Serial.println(estimate.confidence);
+  delay(100);
+}
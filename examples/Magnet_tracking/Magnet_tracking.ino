@@ -0,0 +1,93 @@
+#include <Tli493d.h>
+#include <util/Localize.h>
+
+/**
+* This example tracks position and moment of a magnet above an array of four sensors of the types A0 to A3 on the same bus,
+* placed in a square of 20mm. Every frame is refined by two Levenberg-Marquardt iterations from the previous solution.
+* With SYNTHETIC set to 1 no sensors are needed: the field of a moving magnet is simulated to measure the time per frame.
+*/
+
+#define SYNTHETIC 0
+#define SENSORS 4
+#define ITERATIONS 2
+
+Tli493d sensor[SENSORS] = {
+  Tli493d(Tli493d::MASTERCONTROLLEDMODE, Tli493d::TLI493D_A0),
+  Tli493d(Tli493d::MASTERCONTROLLEDMODE, Tli493d::TLI493D_A1),
+  Tli493d(Tli493d::MASTERCONTROLLEDMODE, Tli493d::TLI493D_A2),
+  Tli493d(Tli493d::MASTERCONTROLLEDMODE, Tli493d::TLI493D_A3)
+};
+const Tli493d::TypeAddress_e address[SENSORS] = {Tli493d::TLI493D_A0, Tli493d::TLI493D_A1, Tli493d::TLI493D_A2, Tli493d::TLI493D_A3};
+
+//sensor positions in mm
+const float positions[SENSORS][3] = {{-10, -10, 0}, {10, -10, 0}, {-10, 10, 0}, {10, 10, 0}};
+float field[SENSORS][3];
+float offset[SENSORS][3];
+tli493d::Localize_t loc;
+
+void readField(float (&b)[SENSORS][3]) {
+  for (uint8_t i = 0; i < SENSORS; i++) {
+    sensor[i].updateData();
+    b[i][0] = sensor[i].getX();
+    b[i][1] = sensor[i].getY();
+    b[i][2] = sensor[i].getZ();
+  }
+}
+
+void setup() {
+  Serial.begin(115200);
+  while (!Serial);
+
+  //start above the centre of the array with the moment pointing up
+  const float position[3] = {0, 0, 20};
+  const float moment[3] = {0, 0, 5000};
+  tli493d::initLocalize(&loc, position, moment);
+
+#if SYNTHETIC
+  uint32_t duration = 0;
+  for (uint16_t frame = 0; frame < 1000; frame++) {
+    float t = frame * 0.01;
+    const tli493d::LocalizeReal_t p[3] = {(tli493d::LocalizeReal_t)(10 * cos(t)), (tli493d::LocalizeReal_t)(10 * sin(t)), 20};
+    const tli493d::LocalizeReal_t m[3] = {0, 0, 5000};
+    for (uint8_t i = 0; i < SENSORS; i++) {
+      tli493d::LocalizeReal_t b[3];
+      tli493d::dipoleField(p, m, positions[i], b);
+      for (uint8_t j = 0; j < 3; j++)
+        field[i][j] = b[j];
+    }
+    uint32_t start = micros();
+    tli493d::localize(&loc, positions, field, SENSORS, ITERATIONS);
+    duration += micros() - start;
+  }
+  Serial.print("Time per frame: ");
+  Serial.print(duration / 1000.0);
+  Serial.println(" us");
+  while (1);
+#else
+  //the reset is a general call and resets all sensors
+  for (uint8_t i = 0; i < SENSORS; i++)
+    sensor[i].begin(Wire, address[i], i == 0, 1);
+
+  //earth field and offsets are measured without magnet
+  Serial.println("Remove the magnet and send any character");
+  while (Serial.available() == 0);
+  while (Serial.available() > 0)
+    Serial.read();
+  readField(offset);
+#endif
+}
+
+void loop() {
+  readField(field);
+  for (uint8_t i = 0; i < SENSORS; i++)
+    for (uint8_t j = 0; j < 3; j++)
+      field[i][j] -= offset[i][j];
+
+  float rms = tli493d::localize(&loc, positions, field, SENSORS, ITERATIONS);
+  for (uint8_t i = 0; i < 3; i++) {
+    Serial.print(loc.position[i]);
+    Serial.print("\t");
+  }
+  Serial.println(rms);
+  delay(10);
+}
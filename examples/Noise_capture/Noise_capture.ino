@@ -0,0 +1,64 @@
+#include <Tli493d.h>
+
+/**
+* This example captures measurements at rest for all ranges and several update rates. The output is to be used with
+* processing/noise_analysis, which computes noise density, Allan deviation and effective resolution.
+* Copy the serial output into processing/noise_analysis/data/capture.csv. Each line: range;rate;time in us;Bx;By;Bz in mT
+*/
+
+#define SAMPLES 2048
+
+//Voltage level LOW at pin 5 switches on the sensor VDD; Operating mode is LOWPOWERMODE
+Tli493d Tli493dMagnetic3DSensor = Tli493d(5, LOW, Tli493d::LOWPOWERMODE);
+
+const Tli493d::Range_e ranges[] = {Tli493d::FULL, Tli493d::SHORT, Tli493d::EXTRASHORT};
+//update rates in low power mode, 0 is the fastest; faster rates are limited by the serial output
+const uint8_t rates[] = {1, 2, 3};
+
+void setup() {
+  Serial.begin(115200);
+  while (!Serial);
+  Tli493dMagnetic3DSensor.begin(true);
+
+  Serial.println("# range;rate;time_us;bx;by;bz");
+  for (uint8_t r = 0; r < sizeof(ranges) / sizeof(ranges[0]); r++) {
+    Tli493dMagnetic3DSensor.setMeasurementRange(ranges[r]);
+    for (uint8_t u = 0; u < sizeof(rates); u++) {
+      Tli493dMagnetic3DSensor.setUpdateRate(rates[u]);
+      capture(ranges[r], rates[u]);
+    }
+  }
+  Serial.println("# done");
+}
+
+void loop() {
+}
+
+//prints every new frame, detected by the frame counter
+void capture(uint8_t range, uint8_t rate) {
+  uint8_t diag[7];
+  uint8_t lastFrame = 0xFF;
+  uint16_t n = 0;
+
+  while (n < SAMPLES) {
+    if (Tli493dMagnetic3DSensor.updateData() != TLI493D_NO_ERROR)
+      continue;
+    Tli493dMagnetic3DSensor.readDiagnosis(diag);
+    if (diag[6] == lastFrame)
+      continue;
+    lastFrame = diag[6];
+    n++;
+
+    Serial.print(range);
+    Serial.print(";");
+    Serial.print(rate);
+    Serial.print(";");
+    Serial.print(micros());
+    Serial.print(";");
+    Serial.print(Tli493dMagnetic3DSensor.getX(), 4);
+    Serial.print(";");
+    Serial.print(Tli493dMagnetic3DSensor.getY(), 4);
+    Serial.print(";");
+    Serial.println(Tli493dMagnetic3DSensor.getZ(), 4);
+  }
+}
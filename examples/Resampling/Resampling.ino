@@ -0,0 +1,67 @@
+#include <Tli493d.h>
+#include <util/Resampler.h>
+
+/**
+* This example turns the irregular samples of the wake-up mode into a uniform stream of 100 values per second,
+* e.g. as input for examples/Vibration_analysis. The sensor only sends an interrupt when the field leaves a window
+* around the last value; in between the last value is held, which is accurate within the window.
+*/
+
+#define PERIOD 10000        //us, 100Hz output
+#define MAX_LATENCY 30000   //us
+#define WAKEUP_DELTA 8      //LSB
+
+//Voltage level LOW at pin 5 switches on the sensor VDD; Operating mode is LOWPOWERMODE
+Tli493d Tli493dMagnetic3DSensor = Tli493d(5, LOW, Tli493d::LOWPOWERMODE);
+
+tli493d::Resampler_t resampler;
+volatile bool dataReady = false;
+volatile uint32_t dataTime;
+
+void setup() {
+  Serial.begin(115200);
+  while (!Serial);
+  Tli493dMagnetic3DSensor.begin(true);
+  Tli493dMagnetic3DSensor.disableTemp();
+  Tli493dMagnetic3DSensor.setUpdateRate(0);
+
+  //the window is recentred by every updateData()
+  Tli493dMagnetic3DSensor.enableWakeUpTracking(WAKEUP_DELTA);
+  Tli493dMagnetic3DSensor.updateData();
+  Tli493dMagnetic3DSensor.enableWakeUp();
+  Tli493dMagnetic3DSensor.enableInterrupt();
+
+  tli493d::initResampler(&resampler, tli493d::RESAMPLE_LINEAR, PERIOD, micros(), MAX_LATENCY);
+  tli493d::addToResampler(&resampler, micros(), Tli493dMagnetic3DSensor.getRawX(), Tli493dMagnetic3DSensor.getRawY(),
+                          Tli493dMagnetic3DSensor.getRawZ());
+
+  //sensor interrupt is connected to pin 9
+  pinMode(9, INPUT_PULLUP);
+  attachInterrupt(digitalPinToInterrupt(9), sensor_irq, FALLING);
+}
+
+void loop() {
+  if (dataReady) {
+    dataReady = false;
+    Tli493dMagnetic3DSensor.updateData();
+    tli493d::addToResampler(&resampler, dataTime, Tli493dMagnetic3DSensor.getRawX(), Tli493dMagnetic3DSensor.getRawY(),
+                            Tli493dMagnetic3DSensor.getRawZ());
+  }
+
+  int16_t out[3];
+  uint32_t time;
+  while (tli493d::getResampled(&resampler, micros(), out, &time)) {
+    Serial.print(time);
+    for (uint8_t i = 0; i < 3; i++) {
+      Serial.print("\t");
+      Serial.print(out[i]);
+    }
+    Serial.println();
+  }
+}
+
+//This function is called, when the sensor sends an interrupt-pulse.
+void sensor_irq() {
+  dataTime = micros();
+  dataReady = true;
+}
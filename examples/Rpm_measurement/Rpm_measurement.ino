@@ -0,0 +1,34 @@
+#include <Tli493d.h>
+#include <util/Rpm.h>
+
+/**
+* This example measures the speed of a shaft with a diametrically magnetized magnet from the crossings of Bx through zero.
+* The crossing times are interpolated between the samples, so the speed resolution is better than the sample interval.
+*/
+
+//Voltage level LOW at pin 5 switches on the sensor VDD; Operating mode is FASTMODE
+Tli493d Tli493dMagnetic3DSensor = Tli493d(5, LOW, Tli493d::FASTMODE);
+
+tli493d::Rpm_t rpm;
+uint32_t lastPrint = 0;
+
+void setup() {
+  Serial.begin(115200);
+  while (!Serial);
+  Tli493dMagnetic3DSensor.begin(true);
+  Tli493dMagnetic3DSensor.disableTemp();
+
+  //crossings of 0 LSB with a hysteresis of 20 LSB, one pole pair, averaging over about 4 periods
+  tli493d::initRpm(&rpm, 0, 20, 1, 2);
+}
+
+void loop() {
+  Tli493dMagnetic3DSensor.updateData();
+  tli493d::addToRpm(&rpm, micros(), Tli493dMagnetic3DSensor.getRawX());
+
+  if (millis() - lastPrint > 500) {
+    lastPrint = millis();
+    Serial.print(tli493d::getRpm(&rpm));
+    Serial.println(tli493d::rpmAliasing(&rpm) ? " rpm (too fast for the sample rate)" : " rpm");
+  }
+}
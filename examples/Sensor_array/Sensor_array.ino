@@ -0,0 +1,61 @@
+#include <Tli493d.h>
+#include <Tli493dArray.h>
+
+/**
+* This example starts four sensors of the types A0 to A3 on the same bus with a common configuration and prints the
+* duration of the bring-up. The configuration is written with one transfer per sensor, and the bus is reset once for
+* all sensors. With more TwoWire modules (e.g. Wire1) up to four sensors can be added per bus, see the buses array.
+* Each read is rated: a sensor which fails repeatedly is excluded from the read cycle and probed now and then, until it
+* works again. Exclusions and readmissions are printed.
+*/
+
+Tli493d sensor0 = Tli493d(Tli493d::MASTERCONTROLLEDMODE, Tli493d::TLI493D_A0);
+Tli493d sensor1 = Tli493d(Tli493d::MASTERCONTROLLEDMODE, Tli493d::TLI493D_A1);
+Tli493d sensor2 = Tli493d(Tli493d::MASTERCONTROLLEDMODE, Tli493d::TLI493D_A2);
+Tli493d sensor3 = Tli493d(Tli493d::MASTERCONTROLLEDMODE, Tli493d::TLI493D_A3);
+Tli493d *const sensors[] = {&sensor0, &sensor1, &sensor2, &sensor3};
+TwoWire *const buses[] = {&Wire, &Wire, &Wire, &Wire};
+Tli493dArray array = Tli493dArray(sensors, 4);
+tli493d::Health_t health[4];
+
+void healthEvent(uint8_t index, uint8_t event, uint8_t score) {
+  Serial.print("Sensor ");
+  Serial.print(index);
+  Serial.print(event == tli493d::HEALTH_EXCLUDED ? " excluded" : " readmitted");
+  Serial.print(", score ");
+  Serial.println(score);
+}
+
+void setup() {
+  Serial.begin(115200);
+  while (!Serial);
+
+  array.setMeasurementRange(Tli493d::SHORT);
+  array.disableTemp();
+  array.setHealth(health);
+  array.setHealthCallback(healthEvent);
+  if (!array.begin(buses, true))
+    Serial.println("Not all sensors could be configured");
+  Serial.print("Bring-up of ");
+  Serial.print(array.getCount());
+  Serial.print(" sensors: ");
+  Serial.print(array.getBeginTime());
+  Serial.println("us");
+}
+
+void loop() {
+  array.updateData();
+  for (uint8_t i = 0; i < array.getCount(); i++) {
+    if (array.isExcluded(i)) {
+      Serial.print("-\t-\t-");
+    } else {
+      Serial.print(array[i].getX());
+      Serial.print("\t");
+      Serial.print(array[i].getY());
+      Serial.print("\t");
+      Serial.print(array[i].getZ());
+    }
+    Serial.print(i + 1 < array.getCount() ? "\t" : "\n");
+  }
+  delay(100);
+}
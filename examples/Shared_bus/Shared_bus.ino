@@ -0,0 +1,108 @@
+#include <Tli493d.h>
+#include <util/BusScheduler.h>
+
+/**
+* This example shares the I2C bus between the sensor and an EEPROM (24LC256 at address 0x50) which logs the field.
+* The sensor is read every 10ms with the highest priority. The EEPROM page writes are split into chunks of 16 bytes
+* and the polling of the write cycle is a chunk of its own, so the sensor read waits at most for one short transfer.
+* A chunk which would run into the next sensor slot is postponed. The worst blocking of each client is printed.
+* A bus recovery is carried out by the configuration job, so it is split into chunks as well.
+*/
+
+#define READ_PERIOD 10000   //us
+#define READ_TIME 300       //us, 7 bytes at 400kHz plus margin
+#define EEPROM_ADDRESS 0x50
+#define EEPROM_CHUNK 16     //bytes per transfer, fits the Wire buffer with the address
+#define EEPROM_PAGE 64
+#define EEPROM_TIME 600     //us, address and 16 bytes at 400kHz plus margin
+
+Tli493d Tli493dMagnetic3DSensor = Tli493d(Tli493d::MASTERCONTROLLEDMODE);
+
+tli493d::BusScheduler_t scheduler;
+tli493d::BusJob_t readJob;
+tli493d::BusJob_t configJob;
+tli493d::BusJob_t eepromJob;
+
+uint8_t page[EEPROM_PAGE];
+uint8_t pageFill = 0;
+uint16_t eepromAddress = 0;
+uint32_t lastPrint = 0;
+
+//chunks 0..3 write the page, the following chunks poll until the EEPROM acknowledges again
+bool eepromStep(void *context, uint8_t chunk) {
+  (void)context;
+  if (chunk < EEPROM_PAGE / EEPROM_CHUNK) {
+    uint16_t address = eepromAddress + chunk * EEPROM_CHUNK;
+    Wire.beginTransmission(EEPROM_ADDRESS);
+    Wire.write(address >> 8);
+    Wire.write(address & 0xFF);
+    Wire.write(&page[chunk * EEPROM_CHUNK], EEPROM_CHUNK);
+    Wire.endTransmission();
+    return false;
+  }
+  Wire.beginTransmission(EEPROM_ADDRESS);
+  if (Wire.endTransmission() != 0 && chunk < 255)
+    return false;
+  eepromAddress += EEPROM_PAGE;
+  return true;
+}
+
+void setup() {
+  Serial.begin(9600);
+  while (!Serial);
+  Tli493dMagnetic3DSensor.begin();
+  Wire.setClock(400000);
+
+  uint32_t now = micros();
+  tli493d::initBusScheduler(&scheduler);
+  tli493d::initBusJob(&readJob, Tli493d::busReadStep, &Tli493dMagnetic3DSensor, 3, READ_PERIOD, READ_PERIOD / 2,
+                      READ_TIME, now);
+  //refreshes the sensor configuration once per second in register sized chunks
+  tli493d::initBusJob(&configJob, Tli493d::busConfigStep, &Tli493dMagnetic3DSensor, 2, 0, 100000, 150, now);
+  tli493d::initBusJob(&eepromJob, eepromStep, NULL, 1, 0, 100000, EEPROM_TIME, now);
+  tli493d::addBusJob(&scheduler, &readJob);
+  tli493d::addBusJob(&scheduler, &configJob);
+  tli493d::addBusJob(&scheduler, &eepromJob);
+}
+
+void loop() {
+  uint32_t now = micros();
+  uint32_t frames = readJob.release;
+  tli493d::runBusScheduler(&scheduler, now);
+
+  //a new sample was read: append it to the page, the page is written while the next one is collected
+  if (readJob.release != frames && pageFill + 6 <= EEPROM_PAGE && !eepromJob.active) {
+    int16_t values[3] = {Tli493dMagnetic3DSensor.getRawX(), Tli493dMagnetic3DSensor.getRawY(),
+                         Tli493dMagnetic3DSensor.getRawZ()};
+    memcpy(&page[pageFill], values, sizeof(values));
+    pageFill += sizeof(values);
+    if (pageFill + 6 > EEPROM_PAGE) {
+      tli493d::submitBusJob(&eepromJob, now);
+      pageFill = 0;
+    }
+  }
+
+  //the read job skips the sensor after a timeout, the config job recovers it in chunks
+  if (Tli493dMagnetic3DSensor.isRecovering())
+    tli493d::submitBusJob(&configJob, now);
+
+  if (now - lastPrint >= 1000000) {
+    lastPrint = now;
+    tli493d::submitBusJob(&configJob, now);
+    Serial.print("sensor: blocked ");
+    Serial.print(readJob.maxBlocking);
+    Serial.print("us (bound ");
+    Serial.print(tli493d::getBusBlockingBound(&scheduler, &readJob));
+    Serial.print("us), misses ");
+    Serial.print(readJob.misses);
+    Serial.print(", error ");
+    Serial.print(Tli493dMagnetic3DSensor.getStepError());
+    Serial.print("\tconfig: blocked ");
+    Serial.print(configJob.maxBlocking);
+    Serial.print("us\teeprom: blocked ");
+    Serial.print(eepromJob.maxBlocking);
+    Serial.print("us, longest chunk ");
+    Serial.print(eepromJob.maxChunk);
+    Serial.println("us");
+  }
+}
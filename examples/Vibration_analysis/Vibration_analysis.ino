@@ -0,0 +1,73 @@
+#include <Tli493d.h>
+#include <util/Spectrum.h>
+
+/**
+* This example demonstrates the spectral analysis of a vibrating magnet in fast mode. A block of Bx samples is analysed by a
+* Goertzel filter bank for a few target frequencies and by a FFT, which gives the dominant frequency.
+* The time needed for both is printed as benchmark.
+*/
+
+#define LOG2N 7
+#define N (1 << LOG2N)
+
+//Voltage level LOW at pin 5 switches on the sensor VDD; Operating mode is FASTMODE
+Tli493d Tli493dMagnetic3DSensor = Tli493d(5, LOW, Tli493d::FASTMODE);
+
+//target frequencies in Hz, e.g. mains and motor frequencies
+const float targets[] = {50.0, 100.0, 150.0};
+tli493d::Goertzel_t bank[sizeof(targets) / sizeof(targets[0])];
+
+int16_t re[N];
+int16_t im[N];
+
+void setup() {
+  Serial.begin(115200);
+  while (!Serial);
+  Tli493dMagnetic3DSensor.begin(true);
+  Tli493dMagnetic3DSensor.disableTemp();
+}
+
+void loop() {
+  //take a block of samples, the sample rate is limited by the I2C read-out
+  uint32_t start = micros();
+  for (uint16_t i = 0; i < N; i++) {
+    Tli493dMagnetic3DSensor.updateData();
+    re[i] = Tli493dMagnetic3DSensor.getRawX();
+    im[i] = 0;
+  }
+  float sampleRate = N * 1e6 / (micros() - start);
+
+  uint32_t t0 = micros();
+  for (uint8_t k = 0; k < sizeof(targets) / sizeof(targets[0]); k++)
+    tli493d::initGoertzel(&bank[k], targets[k], sampleRate);
+  for (uint16_t i = 0; i < N; i++)
+    tli493d::addToGoertzel(bank, sizeof(targets) / sizeof(targets[0]), re[i]);
+  uint32_t t1 = micros();
+
+  tli493d::applyHannWindow(re, LOG2N);
+  tli493d::fft(re, im, LOG2N);
+  uint16_t magnitude;
+  uint16_t bin = tli493d::getDominantBin(re, im, LOG2N, &magnitude);
+  uint32_t t2 = micros();
+
+  Serial.print("fs = ");
+  Serial.print(sampleRate);
+  Serial.print(" Hz; dominant ");
+  Serial.print(bin * sampleRate / N);
+  Serial.print(" Hz (");
+  Serial.print(magnitude);
+  Serial.print(" LSB)");
+  for (uint8_t k = 0; k < sizeof(targets) / sizeof(targets[0]); k++) {
+    Serial.print("; ");
+    Serial.print(targets[k]);
+    Serial.print(" Hz: ");
+    Serial.print(tli493d::getGoertzelAmplitude(&bank[k]));
+  }
+  Serial.print("; goertzel ");
+  Serial.print(t1 - t0);
+  Serial.print(" us; fft ");
+  Serial.print(t2 - t1);
+  Serial.println(" us");
+
+  delay(500);
+}
@@ -0,0 +1,223 @@
+import java.util.concurrent.*;
+
+// Noise characterisation of the TLI493D-W2BW for the choice of range and update rate.
+// Reads data/capture.csv as written by examples/Noise_capture (range;rate;time_us;bx;by;bz in mT).
+// If there is no capture, a noise model of the sensor is simulated instead.
+// Results are written as plot-ready CSV files:
+//   summary.csv: range,rate,axis,fs_hz,sigma_mT,density_uT_per_sqrtHz,effective_bits,noise_free_bits
+//   allan.csv:   range,rate,axis,tau_s,adev_mT
+
+String CAPTURE_FILE = "capture.csv";
+
+// noise model for the simulation: white noise and random walk in LSB, quantisation by the ADC
+int[] SIM_RANGES = {0, 1, 3};
+float[] SIM_SENSITIVITY = {7.7, 15.4, 0, 30.8};   // LSB/mT, index = range
+float[] SIM_RATES_HZ = {770, 97, 24, 12};          // low power update rates 0..3
+float SIM_WHITE_MT = 0.1;
+float SIM_WALK_MT = 0.002;
+int SIM_SAMPLES = 100000;
+
+float[] FULL_SCALE_MT = {160, 100, 0, 50};         // index = range
+
+String[] AXES = {"x", "y", "z"};
+ArrayList<String> summary = new ArrayList<String>();
+ArrayList<String> allan = new ArrayList<String>();
+String status = "";
+
+void setup()
+{
+  size(600, 400);
+  background(127);
+
+  HashMap<String, Capture> captures = loadCaptures(CAPTURE_FILE);
+  if (captures.isEmpty())
+  {
+    captures = simulateCaptures();
+    status = "No " + CAPTURE_FILE + " found, simulated " + captures.size() + " captures";
+  }
+  else
+  {
+    status = "Analysed " + captures.size() + " captures from " + CAPTURE_FILE;
+  }
+  analyse(captures);
+
+  saveStrings("summary.csv", summary.toArray(new String[0]));
+  saveStrings("allan.csv", allan.toArray(new String[0]));
+}
+
+void draw()
+{
+  background(127);
+  fill(255);
+  textSize(14);
+  text(status, 10, 20);
+  for (int i = 0; i < summary.size() && i < 22; i++)
+  {
+    text(summary.get(i), 10, 50 + 16*i);
+  }
+}
+
+class Capture
+{
+  int range;
+  int rate;
+  ArrayList<Double> time = new ArrayList<Double>();
+  ArrayList<double[]> field = new ArrayList<double[]>();
+
+  Capture(int _range, int _rate)
+  {
+    range = _range;
+    rate = _rate;
+  }
+}
+
+class Result
+{
+  String summary;
+  ArrayList<String> allan = new ArrayList<String>();
+}
+
+HashMap<String, Capture> loadCaptures(String file)
+{
+  HashMap<String, Capture> captures = new HashMap<String, Capture>();
+  String[] lines = loadStrings(file);
+  if (lines == null)
+    return captures;
+
+  for (String line : lines)
+  {
+    String[] cols = splitTokens(line, ";, \t");
+    if (line.startsWith("#") || cols.length < 6)
+      continue;
+    try
+    {
+      int range = Integer.parseInt(cols[0]);
+      int rate = Integer.parseInt(cols[1]);
+      String key = range + "," + rate;
+      if (!captures.containsKey(key))
+        captures.put(key, new Capture(range, rate));
+      Capture c = captures.get(key);
+      c.time.add(Double.parseDouble(cols[2]) * 1e-6);
+      c.field.add(new double[] {Double.parseDouble(cols[3]), Double.parseDouble(cols[4]), Double.parseDouble(cols[5])});
+    }
+    catch(NumberFormatException e)
+    {
+      System.err.println("Invalid line: " + line);
+    }
+  }
+  return captures;
+}
+
+HashMap<String, Capture> simulateCaptures()
+{
+  HashMap<String, Capture> captures = new HashMap<String, Capture>();
+  java.util.Random random = new java.util.Random(1);
+
+  for (int range : SIM_RANGES)
+  {
+    for (int rate = 0; rate < SIM_RATES_HZ.length; rate++)
+    {
+      Capture c = new Capture(range, rate);
+      double[] walk = new double[3];
+      for (int n = 0; n < SIM_SAMPLES; n++)
+      {
+        double[] b = new double[3];
+        for (int axis = 0; axis < 3; axis++)
+        {
+          walk[axis] += SIM_WALK_MT * random.nextGaussian();
+          double lsb = (walk[axis] + SIM_WHITE_MT * random.nextGaussian()) * SIM_SENSITIVITY[range];
+          b[axis] = Math.round(lsb) / SIM_SENSITIVITY[range];
+        }
+        c.time.add(n / (double)SIM_RATES_HZ[rate]);
+        c.field.add(b);
+      }
+      captures.put(range + "," + rate, c);
+    }
+  }
+  return captures;
+}
+
+// every capture and axis is analysed in its own task
+void analyse(HashMap<String, Capture> captures)
+{
+  ExecutorService pool = Executors.newFixedThreadPool(Runtime.getRuntime().availableProcessors());
+  ArrayList<Future<Result>> results = new ArrayList<Future<Result>>();
+
+  for (final Capture c : captures.values())
+  {
+    for (int axis = 0; axis < 3; axis++)
+    {
+      final int a = axis;
+      results.add(pool.submit(new Callable<Result>() {
+        public Result call()
+        {
+          return analyseAxis(c, a);
+        }
+      }));
+    }
+  }
+
+  summary.add("range,rate,axis,fs_hz,sigma_mT,density_uT_per_sqrtHz,effective_bits,noise_free_bits");
+  allan.add("range,rate,axis,tau_s,adev_mT");
+  for (Future<Result> f : results)
+  {
+    try
+    {
+      Result r = f.get();
+      summary.add(r.summary);
+      allan.addAll(r.allan);
+    }
+    catch(Exception e)
+    {
+      System.err.println("Analysis failed: " + e.getMessage());
+    }
+  }
+  pool.shutdown();
+}
+
+Result analyseAxis(Capture c, int axis)
+{
+  Result r = new Result();
+  int n = c.field.size();
+  String prefix = c.range + "," + c.rate + "," + AXES[axis] + ",";
+  if (n < 4)
+  {
+    r.summary = prefix + "0,0,0,0,0";
+    return r;
+  }
+
+  // sample rate from the median interval, robust against frames lost while printing
+  double[] dt = new double[n - 1];
+  for (int i = 1; i < n; i++)
+    dt[i - 1] = c.time.get(i) - c.time.get(i - 1);
+  java.util.Arrays.sort(dt);
+  double fs = 1.0 / dt[dt.length / 2];
+
+  // cumulative sum for the overlapping Allan variance
+  double[] sum = new double[n + 1];
+  for (int i = 0; i < n; i++)
+    sum[i + 1] = sum[i] + c.field.get(i)[axis];
+
+  double sigma = 0;
+  for (int m = 1; 2*m < n; m *= 2)
+  {
+    double acc = 0;
+    int terms = n - 2*m + 1;
+    for (int k = 0; k < terms; k++)
+    {
+      double d = sum[k + 2*m] - 2*sum[k + m] + sum[k];
+      acc += d * d;
+    }
+    double adev = Math.sqrt(acc / (2.0 * m * m * terms));
+    if (m == 1)
+      sigma = adev;
+    r.allan.add(prefix + (m / fs) + "," + adev);
+  }
+
+  double fullScale = 2 * FULL_SCALE_MT[c.range];
+  double density = sigma / Math.sqrt(fs / 2) * 1000;
+  double effectiveBits = sigma > 0 ? Math.log(fullScale / sigma) / Math.log(2) : 0;
+  double noiseFreeBits = sigma > 0 ? Math.log(fullScale / (6.6 * sigma)) / Math.log(2) : 0;
+  r.summary = prefix + fs + "," + sigma + "," + density + "," + effectiveBits + "," + noiseFreeBits;
+  return r;
+}
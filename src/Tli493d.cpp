@@ -9,22 +9,60 @@
 #include "Tli493d.h"
 #include "./util/RegMask.h"
 #include "./util/BusInterface2.h"
+#include "./util/IntMath.h"
+#include "./util/Statistics.h"
 #include <math.h>
+#include <string.h>
 
-Tli493d::Tli493d(AccessMode_e mode, TypeAddress_e productType, int powerPin, bool powerLevel) : mMode(mode), mProductType(productType), mPowerPin(powerPin), mPowerLevel(powerLevel)
+//checks if a value measured with X2 (shift 1) or X4 (shift 2) matches the full range value
+static bool scalingPlausible(int16_t full, int16_t scaled, uint8_t shift)
+{
+	int32_t expected = (int32_t)full << shift;
+	//too small to tell the scaling apart from noise, or out of range when scaled
+	if (abs(full) < TLI493D_SELFTEST_MIN_LSB || labs(expected) >= TLI493D_MAX_WU_THR)
+		return true;
+	return labs(scaled - expected) <= labs(expected) / 4 + TLI493D_SELFTEST_NOISE;
+}
+
+//two-sided gaussian quantiles in 1/16 for a false wake-up rate of 10^-n split over three axes, n = 1..6
+static const uint8_t falseWakeQuantiles[] = {34, 47, 57, 66, 74, 82};
+
+Tli493d::Tli493d(AccessMode_e mode, TypeAddress_e productType, int powerPin, bool powerLevel) : mMode(mode), mProductType(productType), mPowerPin(powerPin), mPowerLevel(powerLevel), mSdaPin(NO_BUS_PIN), mSclPin(NO_BUS_PIN)
 {
 	mXdata = 0;
 	mYdata = 0;
 	mZdata = 0;
 	mTempdata = 0;
+	mWuDelta = 0;
+	mTuning.samples = 0;
+	mStats = NULL;
+	mRecovering = false;
+	mStepRecovery = false;
+	mStepError = TLI493D_NO_ERROR;
+	mBusLock = NULL;
+	mConfigLock = NULL;
+	mSampleSeq = 0;
+	setSoftWakeUpThresholdLSB(TLI493D_MAX_WU_THR - 1, -TLI493D_MAX_WU_THR, TLI493D_MAX_WU_THR - 1, -TLI493D_MAX_WU_THR,
+							  TLI493D_MAX_WU_THR - 1, -TLI493D_MAX_WU_THR);
 }
 
-Tli493d::Tli493d(int powerPin, bool powerLevel, AccessMode_e mode, TypeAddress_e productType) : mMode(mode), mProductType(productType), mPowerPin(powerPin), mPowerLevel(powerLevel)
+Tli493d::Tli493d(int powerPin, bool powerLevel, AccessMode_e mode, TypeAddress_e productType) : mMode(mode), mProductType(productType), mPowerPin(powerPin), mPowerLevel(powerLevel), mSdaPin(NO_BUS_PIN), mSclPin(NO_BUS_PIN)
 {
 	mXdata = 0;
 	mYdata = 0;
 	mZdata = 0;
 	mTempdata = 0;
+	mWuDelta = 0;
+	mTuning.samples = 0;
+	mStats = NULL;
+	mRecovering = false;
+	mStepRecovery = false;
+	mStepError = TLI493D_NO_ERROR;
+	mBusLock = NULL;
+	mConfigLock = NULL;
+	mSampleSeq = 0;
+	setSoftWakeUpThresholdLSB(TLI493D_MAX_WU_THR - 1, -TLI493D_MAX_WU_THR, TLI493D_MAX_WU_THR - 1, -TLI493D_MAX_WU_THR,
+							  TLI493D_MAX_WU_THR - 1, -TLI493D_MAX_WU_THR);
 }
 
 Tli493d::~Tli493d(void)
@@ -44,31 +82,9 @@ void Tli493d::begin(bool reset)
 
 void Tli493d::begin(TwoWire &bus, TypeAddress_e slaveAddress, bool reset, uint8_t oneByteRead)
 {
-	if(mPowerPin != NO_POWER_PIN)
-	{
-		//TURN ON THE SENSOR
-		pinMode(mPowerPin, OUTPUT);
-		digitalWrite(mPowerPin, mPowerLevel);
-	}
+	powerOn();
 	delay(100);
-	initInterface(&mInterface, &bus, slaveAddress, tli493d::resetValues);
-	
-	//correct reset values for other product types
-	switch (mProductType)
-	{
-	case TLI493D_A1:
-		setRegBits(tli493d::IICadr, 0b01);
-		break;
-	case TLI493D_A2:
-		setRegBits(tli493d::IICadr, 0b10);
-		break;
-	case TLI493D_A3:
-		setRegBits(tli493d::IICadr, 0b11);
-		break;
-	default:
-		break;
-	}
-	
+	initSensor(bus, slaveAddress);
 	mInterface.bus->begin();
 	if (reset)
 	{
@@ -111,8 +127,43 @@ void Tli493d::begin(TwoWire &bus, TypeAddress_e slaveAddress, bool reset, uint8_
 	delay(TLI493D_STARTUPDELAY);
 }
 
+void Tli493d::powerOn(void)
+{
+	if(mPowerPin != NO_POWER_PIN)
+	{
+		//TURN ON THE SENSOR
+		pinMode(mPowerPin, OUTPUT);
+		digitalWrite(mPowerPin, mPowerLevel);
+	}
+}
+
+void Tli493d::initSensor(TwoWire &bus, TypeAddress_e slaveAddress)
+{
+	initInterface(&mInterface, &bus, slaveAddress, tli493d::resetValues);
+	mInterface.lock = mBusLock;
+	
+	//correct reset values for other product types
+	switch (mProductType)
+	{
+	case TLI493D_A1:
+		setRegBits(tli493d::IICadr, 0b01);
+		break;
+	case TLI493D_A2:
+		setRegBits(tli493d::IICadr, 0b10);
+		break;
+	case TLI493D_A3:
+		setRegBits(tli493d::IICadr, 0b11);
+		break;
+	default:
+		break;
+	}
+	tli493d::setTimeouts(&mInterface, TLI493D_READ_TIMEOUT, TLI493D_WRITE_TIMEOUT);
+	mRecovering = false;
+}
+
 bool Tli493d::setAccessMode(AccessMode_e mode)
 {
+	tli493d::LockGuard guard(mConfigLock);
 	if (mode == 2 || mode > 3)
 		return false;
 	
@@ -144,23 +195,17 @@ bool Tli493d::setAccessMode(AccessMode_e mode)
 
 void Tli493d::setTrigger(uint8_t trigger)
 {
+	tli493d::LockGuard guard(mConfigLock);
 	if(trigger > 3u || mMode == LOWPOWERMODE)
 		return;
 	setRegBits(tli493d::TRIG, trigger);
 	calcParity(tli493d::CP);
 	tli493d::writeOut(&mInterface, tli493d::CONFIG_REGISTER);
-	
-	tli493d::readOut(&mInterface);
-	for(int i = 0; i < 0x17; i++)
-	{
-		Serial.print(i,HEX);
-		Serial.print(": ");
-		Serial.println(mInterface.regData[i],HEX);
-	}
 }
 
 void Tli493d::enableInterrupt(void)
 {
+	tli493d::LockGuard guard(mConfigLock);
 	setRegBits(tli493d::INT, 0);
 	calcParity(tli493d::FP);
 	tli493d::writeOut(&mInterface, tli493d::MOD1_REGISTER);
@@ -168,6 +213,7 @@ void Tli493d::enableInterrupt(void)
 
 void Tli493d::disableInterrupt(void)
 {
+	tli493d::LockGuard guard(mConfigLock);
 	setRegBits(tli493d::INT, 1);
 	calcParity(tli493d::FP);
 	tli493d::writeOut(&mInterface, tli493d::MOD1_REGISTER);
@@ -175,6 +221,7 @@ void Tli493d::disableInterrupt(void)
 
 void Tli493d::enableCollisionAvoidance(void)
 {
+	tli493d::LockGuard guard(mConfigLock);
 	setRegBits(tli493d::CA, 0);
 	calcParity(tli493d::FP);
 	tli493d::writeOut(&mInterface, tli493d::MOD1_REGISTER);
@@ -182,6 +229,7 @@ void Tli493d::enableCollisionAvoidance(void)
 
 void Tli493d::disableCollisionAvoidance(void)
 {
+	tli493d::LockGuard guard(mConfigLock);
 	setRegBits(tli493d::CA, 1);
 	calcParity(tli493d::FP);
 	tli493d::writeOut(&mInterface, tli493d::MOD1_REGISTER);
@@ -189,6 +237,7 @@ void Tli493d::disableCollisionAvoidance(void)
 
 void Tli493d::enableTemp(void)
 {
+	tli493d::LockGuard guard(mConfigLock);
 	setRegBits(tli493d::DT, 0);
 	calcParity(tli493d::CP);
 	tli493d::writeOut(&mInterface, tli493d::CONFIG_REGISTER);
@@ -196,6 +245,7 @@ void Tli493d::enableTemp(void)
 
 void Tli493d::disableTemp(void)
 {
+	tli493d::LockGuard guard(mConfigLock);
 	setRegBits(tli493d::DT, 1);
 	calcParity(tli493d::CP);
 	tli493d::writeOut(&mInterface, tli493d::CONFIG_REGISTER);
@@ -203,6 +253,7 @@ void Tli493d::disableTemp(void)
 
  void Tli493d::enableBz(void)
 {
+	tli493d::LockGuard guard(mConfigLock);
 	setRegBits(tli493d::AM, 0);
 	calcParity(tli493d::CP);
 	tli493d::writeOut(&mInterface, tli493d::CONFIG_REGISTER);
@@ -210,12 +261,14 @@ void Tli493d::disableTemp(void)
 
 void Tli493d::disableBz(void)
 {
+	tli493d::LockGuard guard(mConfigLock);
 	setRegBits(tli493d::AM, 1);
 	calcParity(tli493d::CP);
 	tli493d::writeOut(&mInterface, tli493d::CONFIG_REGISTER);
 }
 
 bool Tli493d::setWakeUpThreshold(float xh_th, float xl_th, float yh_th, float yl_th, float zh_th, float zl_th){
+	tli493d::LockGuard guard(mConfigLock);
 	//all thresholds should be within [-1,1], upper thresholds should be greater than lower thresholds
 	if(xh_th>1 || xl_th<-1 || xl_th>xh_th ||
 		yh_th>1 || yl_th<-1 || yl_th>yh_th||
@@ -263,6 +316,7 @@ bool Tli493d::setWakeUpThreshold(float xh_th, float xl_th, float yh_th, float yl
 }
 
 bool Tli493d::setWakeUpThresholdLSB(int16_t xh_th, int16_t xl_th, int16_t yh_th, int16_t yl_th, int16_t zh_th, int16_t zl_th){
+	tli493d::LockGuard guard(mConfigLock);
 	if(xh_th>TLI493D_MAX_WU_THR-1|| xl_th<-TLI493D_MAX_WU_THR || xl_th>xh_th ||
 		yh_th>TLI493D_MAX_WU_THR-1 || yl_th<-TLI493D_MAX_WU_THR || yl_th>yh_th||
 		zh_th>TLI493D_MAX_WU_THR-1 || zl_th<-TLI493D_MAX_WU_THR || zl_th>zh_th)
@@ -311,6 +365,7 @@ bool Tli493d::setWakeUpThresholdLSB(int16_t xh_th, int16_t xl_th, int16_t yh_th,
 }
 
 bool Tli493d::setWakeUpThresholdMT(float xh_th, float xl_th, float yh_th, float yl_th, float zh_th, float zl_th){
+	tli493d::LockGuard guard(mConfigLock);
 	if(xh_th>(TLI493D_MAX_WU_THR-1)/mBMult|| xl_th<-TLI493D_MAX_WU_THR/mBMult || xl_th>xh_th ||
 		yh_th>(TLI493D_MAX_WU_THR-1)/mBMult || yl_th<-TLI493D_MAX_WU_THR/mBMult || yl_th>yh_th||
 		zh_th>(TLI493D_MAX_WU_THR-1)/mBMult || zl_th<-TLI493D_MAX_WU_THR/mBMult || zl_th>zh_th)
@@ -358,12 +413,143 @@ bool Tli493d::setWakeUpThresholdMT(float xh_th, float xl_th, float yh_th, float
 	return ret;
 }
 
+bool Tli493d::enableWakeUpTracking(int16_t delta){
+	tli493d::LockGuard guard(mConfigLock);
+	if(delta < 1 || delta > TLI493D_MAX_WU_THR / 2)
+		return false;
+	mWuDelta = delta;
+	return true;
+}
+
+void Tli493d::disableWakeUpTracking(void){
+	tli493d::LockGuard guard(mConfigLock);
+	mWuDelta = 0;
+}
+
+bool Tli493d::autoTuneWakeUp(uint16_t samples, uint8_t falseWakeExp){
+	tli493d::LockGuard guard(mConfigLock);
+	if(samples < 2 || falseWakeExp < 1 || falseWakeExp > sizeof(falseWakeQuantiles))
+		return false;
+
+	uint8_t config[TLI493D_NUM_REG];
+	tli493d::Welford_t stats[4];
+	bool ret = true;
+	memcpy(config, mInterface.regData, TLI493D_NUM_REG);
+	for (uint8_t i = 0; i < 4; i++)
+		tli493d::initWelford(&stats[i]);
+
+	//every read triggers a new measurement, so consecutive samples are independent
+	setRegBits(tli493d::TRIG, 1);
+	setRegBits(tli493d::MODE, MASTERCONTROLLEDMODE);
+	calcParity(tli493d::CP);
+	calcParity(tli493d::FP);
+	if (tli493d::writeOut(&mInterface, tli493d::CONFIG_REGISTER) != BUS_OK ||
+		tli493d::writeOut(&mInterface, tli493d::MOD1_REGISTER) != BUS_OK)
+		ret = false;
+
+	for (uint16_t n = 0; n < samples && ret; n++)
+	{
+		if (readData() != TLI493D_NO_ERROR)
+		{
+			ret = false;
+			break;
+		}
+		tli493d::addToWelford(&stats[0], mXdata);
+		tli493d::addToWelford(&stats[1], mYdata);
+		tli493d::addToWelford(&stats[2], mZdata);
+		tli493d::addToWelford(&stats[3], mTempdata);
+	}
+
+	memcpy(mInterface.regData, config, TLI493D_NUM_REG);
+	if (ret)
+	{
+		for (uint8_t i = 0; i < 3; i++)
+		{
+			//window = mean +/- (k * sigma + margin), sigma has TLI493D_WELFORD_VAR_SHIFT / 2 fractional bits
+			uint32_t sigma = tli493d::sqrtInt(tli493d::getWelfordVariance(&stats[i]));
+			int32_t half = ((sigma * falseWakeQuantiles[falseWakeExp - 1]) >> (TLI493D_WELFORD_VAR_SHIFT / 2 + 4)) + TLI493D_TUNE_MARGIN;
+			int32_t mean = tli493d::getWelfordMean(&stats[i]);
+			if (2 * half > TLI493D_MAX_WU_THR || mean + half > TLI493D_MAX_WU_THR - 1 || mean - half < -TLI493D_MAX_WU_THR)
+				ret = false;
+			mTuning.threshold[2 * i] = constrain(mean + half, -TLI493D_MAX_WU_THR, TLI493D_MAX_WU_THR - 1);
+			mTuning.threshold[2 * i + 1] = constrain(mean - half, -TLI493D_MAX_WU_THR, TLI493D_MAX_WU_THR - 1);
+		}
+		mTuning.temp = tli493d::getWelfordMean(&stats[3]);
+		mTuning.samples = samples;
+		mTuning.falseWakeExp = falseWakeExp;
+		mTuning.range = getRegBits(tli493d::X2) | (getRegBits(tli493d::X4) << 1);
+		setWakeUpRegs(mTuning.threshold);
+	}
+	if (!writeConfig())
+		ret = false;
+	return ret;
+}
+
+void Tli493d::getWakeUpTuning(Tli493d_WakeUpTuning_t &tuning){
+	tli493d::LockGuard guard(mConfigLock);
+	tuning = mTuning;
+}
+
+bool Tli493d::setWakeUpTuning(const Tli493d_WakeUpTuning_t &tuning){
+	tli493d::LockGuard guard(mConfigLock);
+	if (tuning.range != (getRegBits(tli493d::X2) | (getRegBits(tli493d::X4) << 1)))
+		return false;
+	mTuning = tuning;
+	setWakeUpRegs(mTuning.threshold);
+	calcParity(tli493d::CP);
+	return tli493d::writeOut(&mInterface, tli493d::regMasks[tli493d::XL].byteAdress, TLI493D_WU_BURST) == BUS_OK;
+}
+
+bool Tli493d::retuneWakeUp(void){
+	tli493d::LockGuard guard(mConfigLock);
+	if (mTuning.samples == 0 || abs(mTempdata - mTuning.temp) <= TLI493D_TUNE_TEMP_DELTA)
+		return false;
+	return autoTuneWakeUp(mTuning.samples, mTuning.falseWakeExp);
+}
+
+bool Tli493d::setSoftWakeUpThresholdLSB(int16_t xh_th, int16_t xl_th, int16_t yh_th, int16_t yl_th, int16_t zh_th, int16_t zl_th){
+	tli493d::LockGuard guard(mConfigLock);
+	if(xh_th>TLI493D_MAX_WU_THR-1|| xl_th<-TLI493D_MAX_WU_THR || xl_th>xh_th ||
+		yh_th>TLI493D_MAX_WU_THR-1 || yl_th<-TLI493D_MAX_WU_THR || yl_th>yh_th||
+		zh_th>TLI493D_MAX_WU_THR-1 || zl_th<-TLI493D_MAX_WU_THR || zl_th>zh_th)
+		return false;
+
+	mSoftWuHigh[0] = xh_th; mSoftWuLow[0] = xl_th;
+	mSoftWuHigh[1] = yh_th; mSoftWuLow[1] = yl_th;
+	mSoftWuHigh[2] = zh_th; mSoftWuLow[2] = zl_th;
+	return true;
+}
+
+bool Tli493d::setSoftWakeUpThresholdMT(float xh_th, float xl_th, float yh_th, float yl_th, float zh_th, float zl_th){
+	tli493d::LockGuard guard(mConfigLock);
+	if(xh_th>(TLI493D_MAX_WU_THR-1)*mBMult|| xl_th<-TLI493D_MAX_WU_THR*mBMult || xl_th>xh_th ||
+		yh_th>(TLI493D_MAX_WU_THR-1)*mBMult || yl_th<-TLI493D_MAX_WU_THR*mBMult || yl_th>yh_th||
+		zh_th>(TLI493D_MAX_WU_THR-1)*mBMult || zl_th<-TLI493D_MAX_WU_THR*mBMult || zl_th>zh_th)
+		return false;
+
+	return setSoftWakeUpThresholdLSB((int16_t)(xh_th/mBMult), (int16_t)(xl_th/mBMult),
+									 (int16_t)(yh_th/mBMult), (int16_t)(yl_th/mBMult),
+									 (int16_t)(zh_th/mBMult), (int16_t)(zl_th/mBMult));
+}
+
+bool Tli493d::checkSoftWakeUp(void){
+	//no config lock: only the measurement registers of the local copy are written
+	if (!readField())
+		return false;
+
+	return mXdata > mSoftWuHigh[0] || mXdata < mSoftWuLow[0] ||
+		   mYdata > mSoftWuHigh[1] || mYdata < mSoftWuLow[1] ||
+		   mZdata > mSoftWuHigh[2] || mZdata < mSoftWuLow[2];
+}
+
 bool Tli493d::wakeUpEnabled(void){
+	tli493d::LockGuard guard(mConfigLock);
 	tli493d::readOut(&mInterface);
 	return (bool)getRegBits(tli493d::WA);
 }
 
 void Tli493d::enableWakeUp(void){
+	tli493d::LockGuard guard(mConfigLock);
 	setRegBits(tli493d::WU, 1);
 	calcParity(tli493d::CP);
 	tli493d::writeOut(&mInterface, tli493d::WAKEUP_REGISTER);
@@ -371,6 +557,7 @@ void Tli493d::enableWakeUp(void){
 }
 
 void Tli493d::disableWakeUp(void){
+	tli493d::LockGuard guard(mConfigLock);
 	setRegBits(tli493d::WU, 0);
 	calcParity(tli493d::CP);
 	tli493d::writeOut(&mInterface, tli493d::WAKEUP_REGISTER);
@@ -378,6 +565,7 @@ void Tli493d::disableWakeUp(void){
 }
 
 void Tli493d::setUpdateRate(uint8_t updateRate){
+	tli493d::LockGuard guard(mConfigLock);
 	if(updateRate>7) updateRate = 7;
 	setRegBits(tli493d::PRD, updateRate);
 	calcParity(tli493d::FP);
@@ -386,6 +574,7 @@ void Tli493d::setUpdateRate(uint8_t updateRate){
 }
 
 bool Tli493d::setMeasurementRange(Range_e range) {
+	tli493d::LockGuard guard(mConfigLock);
 	if(range == 2 || range > 3)
 		return false;
 	if(range == EXTRASHORT && getRegBits(tli493d::WA))	//X4 cannot be used together with WakeUp. Please call disableWakeUp() first.
@@ -413,19 +602,92 @@ bool Tli493d::setMeasurementRange(Range_e range) {
 
 Tli493d_Error_t Tli493d::updateData(void)
 {
-	Tli493d_Error_t ret = TLI493D_NO_ERROR;
+	Tli493d_Error_t ret;
 
-	if (readOut(&mInterface, TLI493D_MEASUREMENT_READOUT) != BUS_OK)
+	//a missed deadline is recovered by the next call, so that each call has a bounded duration
+	if (mRecovering)
+	{
+		if (!recoverBus())
+			return TLI493D_TIMEOUT_ERROR;
+	}
+	ret = readSample();
+	//the sensor may hold SDA low after an interrupted transfer, e.g. a reset of the uC
+	if (ret == TLI493D_BUS_ERROR && mRecovering)
+	{
+		recoverBus();
+	}
+	return ret;
+}
+
+Tli493d_Error_t Tli493d::readSample(void)
+{
+	Tli493d_Error_t ret = readData();
+
+	if (ret != TLI493D_NO_ERROR)
+	{
+		if (ret == TLI493D_TIMEOUT_ERROR || mInterface.errorCount >= TLI493D_MAX_BUS_ERRORS)
+			mRecovering = true;
+		return ret;
+	}
+
+	if (mStats != NULL)
 	{
-		ret = TLI493D_BUS_ERROR;
+		tli493d::addToStatistics(&mStats->channel[tli493d::STAT_X], mXdata);
+		tli493d::addToStatistics(&mStats->channel[tli493d::STAT_Y], mYdata);
+		tli493d::addToStatistics(&mStats->channel[tli493d::STAT_Z], mZdata);
+		tli493d::addToStatistics(&mStats->channel[tli493d::STAT_TEMP], mTempdata);
 	}
+	if (mWuDelta != 0)
+	{
+		trackWakeUp();
+	}
+	return ret;
+}
+
+Tli493d_Error_t Tli493d::readData(void)
+{
+	if (readOut(&mInterface, TLI493D_MEASUREMENT_READOUT) != BUS_OK)
+		return mInterface.timedOut ? TLI493D_TIMEOUT_ERROR : TLI493D_BUS_ERROR;
+
 	//no concatenation for 8 bit resolution
+	//odd sequence: readers of getRawData() retry instead of blocking
+	mSampleSeq++;
+	TLI493D_MEMORY_BARRIER();
 	mXdata = concatResults(getRegBits(tli493d::BX1), getRegBits(tli493d::BX2), true);
 	mYdata = concatResults(getRegBits(tli493d::BY1), getRegBits(tli493d::BY2), true);
 	mZdata = concatResults(getRegBits(tli493d::BZ1), getRegBits(tli493d::BZ2), true);
 	mTempdata = concatResults(getRegBits(tli493d::TEMP1), getRegBits(tli493d::TEMP2), false);
+	TLI493D_MEMORY_BARRIER();
+	mSampleSeq++;
+	return TLI493D_NO_ERROR;
+}
 
-	return ret;
+void Tli493d::setStatistics(tli493d::Statistics_t *stats)
+{
+	if (stats != NULL)
+		tli493d::initStatistics(stats);
+	noInterrupts();
+	mStats = stats;
+	interrupts();
+}
+
+void Tli493d::resetStatistics(void)
+{
+	if (mStats == NULL)
+		return;
+	noInterrupts();
+	tli493d::resetStatistics(mStats);
+	interrupts();
+}
+
+bool Tli493d::getStatistics(tli493d::Statistics_t &snapshot)
+{
+	if (mStats == NULL)
+		return false;
+	noInterrupts();
+	snapshot = *mStats;
+	interrupts();
+	return true;
 }
 
 float Tli493d::getX(void)
@@ -448,6 +710,48 @@ float Tli493d::getTemp(void)
 	return static_cast<float>(mTempdata - TLI493D_TEMP_OFFSET) * TLI493D_TEMP_MULT + TLI493D_TEMP_25;
 }
 
+void Tli493d::getRawData(int16_t (&raw)[4])
+{
+	uint16_t seq;
+	do
+	{
+		seq = mSampleSeq;
+		TLI493D_MEMORY_BARRIER();
+		raw[0] = mXdata;
+		raw[1] = mYdata;
+		raw[2] = mZdata;
+		raw[3] = mTempdata;
+		TLI493D_MEMORY_BARRIER();
+	} while ((seq & 1) || seq != mSampleSeq);
+}
+
+void Tli493d::setLocks(const tli493d::Lock_t *busLock, const tli493d::Lock_t *configLock)
+{
+	mBusLock = busLock;
+	mConfigLock = configLock;
+	mInterface.lock = busLock;
+}
+
+int16_t Tli493d::getRawX(void)
+{
+	return mXdata;
+}
+
+int16_t Tli493d::getRawY(void)
+{
+	return mYdata;
+}
+
+int16_t Tli493d::getRawZ(void)
+{
+	return mZdata;
+}
+
+int16_t Tli493d::getRawTemp(void)
+{
+	return mTempdata;
+}
+
 float Tli493d::getNorm(void)
 {
 	return mBMult * sqrt(pow(static_cast<float>(mXdata), 2) + pow(static_cast<float>(mYdata), 2) + pow(static_cast<float>(mZdata), 2));
@@ -463,11 +767,23 @@ float Tli493d::getPolar(void)
 	return atan2(static_cast<float>(mZdata), sqrt(pow(static_cast<float>(mXdata), 2) + pow(static_cast<float>(mYdata), 2)));
 }
 
+tli493d::Bam_t Tli493d::getAzimuthBam(void)
+{
+	return tli493d::atan2Int(mYdata, mXdata);
+}
+
+tli493d::Bam_t Tli493d::getPolarBam(void)
+{
+	uint16_t rho = tli493d::sqrtInt((int32_t)mXdata * mXdata + (int32_t)mYdata * mYdata);
+	return tli493d::atan2Int(mZdata, rho);
+}
+
 /* CAUTION: If the microcontroller is reset, the communication with the sensor may be corrupted, possibly causing the
 	sensor to enter an incorrect state. After a reset, the sensor must be reconfigured to the desired settings.
 */
 void Tli493d::resetSensor()
 {
+	tli493d::LockGuard guard(mBusLock);
 	mInterface.bus->requestFrom(0xFF, 0);
 	mInterface.bus->requestFrom(0xFF, 0);
 	mInterface.bus->beginTransmission(0x00);
@@ -483,6 +799,7 @@ void Tli493d::resetSensor()
 
 void Tli493d::readDiagnosis(uint8_t (&diag)[7])
 {
+	tli493d::LockGuard guard(mConfigLock);
 	//P, FF, CF, T, PD3, PD0, FRM
 	diag[0] = getRegBits(tli493d::CP);
 	diag[1] = getRegBits(tli493d::FF);
@@ -492,6 +809,365 @@ void Tli493d::readDiagnosis(uint8_t (&diag)[7])
 	diag[5] = getRegBits(tli493d::PD_0);
 	diag[6] = getRegBits(tli493d::FRM);
 }
+
+uint8_t Tli493d::selfTest(void)
+{
+	tli493d::LockGuard guard(mConfigLock);
+	uint8_t ret = TLI493D_SELFTEST_OK;
+	uint8_t config[TLI493D_NUM_REG];
+	float bMult = mBMult;
+	int16_t full[3] = {0, 0, 0};
+	int16_t raw[3];
+	memcpy(config, mInterface.regData, TLI493D_NUM_REG);
+
+	//measurement is triggered by each read, X4 sets the T bit which does not work together with wake-up
+	setRegBits(tli493d::WU, 0);
+	setRegBits(tli493d::TRIG, 1);
+	setRegBits(tli493d::MODE, MASTERCONTROLLEDMODE);
+	setRegBits(tli493d::DT, 0);
+	setRegBits(tli493d::AM, 0);
+
+	for (uint8_t shift = 0; shift <= 2; shift++)
+	{
+		setRegBits(tli493d::X2, shift == 1);
+		setRegBits(tli493d::X4, shift == 2);
+		calcParity(tli493d::CP);
+		calcParity(tli493d::FP);
+		if (tli493d::writeOut(&mInterface, tli493d::MOD1_REGISTER) != BUS_OK ||
+			tli493d::writeOut(&mInterface, tli493d::WAKEUP_REGISTER) != BUS_OK ||
+			tli493d::writeOut(&mInterface, tli493d::CONFIG_REGISTER) != BUS_OK ||
+			tli493d::writeOut(&mInterface, tli493d::CONFIG2_REGISTER) != BUS_OK)
+		{
+			ret |= TLI493D_SELFTEST_BUS;
+			break;
+		}
+		ret |= selfTestStep(raw);
+
+		if (shift == 0)
+		{
+			float temp = getTemp();
+			if (temp < TLI493D_SELFTEST_TEMP_MIN || temp > TLI493D_SELFTEST_TEMP_MAX)
+				ret |= TLI493D_SELFTEST_TEMP;
+			memcpy(full, raw, sizeof(full));
+		}
+		else
+		{
+			for (uint8_t i = 0; i < 3; i++)
+			{
+				if (!scalingPlausible(full[i], raw[i], shift))
+					ret |= TLI493D_SELFTEST_RANGE;
+			}
+		}
+	}
+
+	//channel enables: temperature off, then Bz off as well (Bz can only be disabled without temperature)
+	for (uint8_t i = 0; i < 2 && !(ret & TLI493D_SELFTEST_BUS); i++)
+	{
+		setRegBits(i == 0 ? tli493d::DT : tli493d::AM, 1);
+		calcParity(tli493d::CP);
+		if (tli493d::writeOut(&mInterface, tli493d::CONFIG_REGISTER) != BUS_OK)
+		{
+			ret |= TLI493D_SELFTEST_BUS;
+			break;
+		}
+		ret |= selfTestStep(raw);
+	}
+
+	memcpy(mInterface.regData, config, TLI493D_NUM_REG);
+	mBMult = bMult;
+	if (!writeConfig())
+		ret |= TLI493D_SELFTEST_BUS;
+	return ret;
+}
+
+void Tli493d::setWakeUpRegs(const int16_t (&th)[6])
+{
+	static const uint8_t msb[6] = {tli493d::XH, tli493d::XL, tli493d::YH, tli493d::YL, tli493d::ZH, tli493d::ZL};
+	static const uint8_t lsb[6] = {tli493d::XH2, tli493d::XL2, tli493d::YH2, tli493d::YL2, tli493d::ZH2, tli493d::ZL2};
+	bool yToZ = getRegBits(tli493d::AM) == 1 && getRegBits(tli493d::DT) == 1;
+
+	for (uint8_t i = 0; i < 6; i++)
+	{
+		//When Temp and Bz measurements are disabled, Y-thresholds must be written to Z-threshold registers
+		int16_t value = (yToZ && i >= 4 ? th[i - 2] : th[i]) >> 1;
+		setRegBits(msb[i], (value & TLI493D_MSB_MASK) >> 3);
+		setRegBits(lsb[i], value & TLI493D_LSB_MASK);
+	}
+}
+
+int16_t Tli493d::getWakeUpReg(uint8_t msbIndex, uint8_t lsbIndex)
+{
+	//11 bit two's complement, shifted to the 12 bit range of the measurement values
+	int16_t value = ((int16_t)getRegBits(msbIndex) << 3) | getRegBits(lsbIndex);
+	if (value & 0x0400)
+		value |= 0xF800;
+	return value << 1;
+}
+
+bool Tli493d::readField(void)
+{
+	if (readOut(&mInterface, TLI493D_SOFTWU_READOUT) != BUS_OK)
+		return false;
+
+	mSampleSeq++;
+	TLI493D_MEMORY_BARRIER();
+	mXdata = concatResults(getRegBits(tli493d::BX1), getRegBits(tli493d::BX2), true);
+	mYdata = concatResults(getRegBits(tli493d::BY1), getRegBits(tli493d::BY2), true);
+	mZdata = concatResults(getRegBits(tli493d::BZ1), getRegBits(tli493d::BZ2), true);
+	TLI493D_MEMORY_BARRIER();
+	mSampleSeq++;
+	return true;
+}
+
+void Tli493d::trackWakeUp(void)
+{
+	tli493d::LockGuard guard(mConfigLock);
+	int16_t data[3] = {mXdata, mYdata, mZdata};
+	int16_t th[6];
+	bool outside = false;
+	//without Bz (AM = 1) there is no Z value, and with DT = 1 the Z registers hold the Y thresholds
+	bool checkZ = getRegBits(tli493d::AM) == 0;
+
+	if (data[0] > getWakeUpReg(tli493d::XH, tli493d::XH2) || data[0] < getWakeUpReg(tli493d::XL, tli493d::XL2) ||
+		data[1] > getWakeUpReg(tli493d::YH, tli493d::YH2) || data[1] < getWakeUpReg(tli493d::YL, tli493d::YL2))
+		outside = true;
+	if (checkZ && (data[2] > getWakeUpReg(tli493d::ZH, tli493d::ZH2) || data[2] < getWakeUpReg(tli493d::ZL, tli493d::ZL2)))
+		outside = true;
+	if (!outside)
+		return;
+
+	for (uint8_t i = 0; i < 3; i++)
+	{
+		//keep the full width at the borders of the output range
+		int16_t low = data[i] - mWuDelta;
+		if (low < -TLI493D_MAX_WU_THR)
+			low = -TLI493D_MAX_WU_THR;
+		if (low > TLI493D_MAX_WU_THR - 1 - 2 * mWuDelta)
+			low = TLI493D_MAX_WU_THR - 1 - 2 * mWuDelta;
+		th[2 * i] = low + 2 * mWuDelta;
+		th[2 * i + 1] = low;
+	}
+
+	setWakeUpRegs(th);
+	calcParity(tli493d::CP);
+	tli493d::writeOut(&mInterface, tli493d::regMasks[tli493d::XL].byteAdress, TLI493D_WU_BURST);
+}
+
+uint8_t Tli493d::selfTestStep(int16_t (&raw)[3])
+{
+	uint8_t ret = TLI493D_SELFTEST_OK;
+	uint8_t frame;
+
+	if (readData() != TLI493D_NO_ERROR)
+		return TLI493D_SELFTEST_BUS;
+	frame = getRegBits(tli493d::FRM);
+	if (readData() != TLI493D_NO_ERROR)
+		return TLI493D_SELFTEST_BUS;
+
+	if (getRegBits(tli493d::FRM) == frame)
+		ret |= TLI493D_SELFTEST_FRAME;
+	if (getRegBits(tli493d::FF) == 0 || getRegBits(tli493d::CF) == 0)
+		ret |= TLI493D_SELFTEST_PARITY;
+	raw[0] = mXdata;
+	raw[1] = mYdata;
+	raw[2] = mZdata;
+	return ret;
+}
+
+void Tli493d::setBusPins(int sdaPin, int sclPin)
+{
+	mSdaPin = sdaPin;
+	mSclPin = sclPin;
+}
+
+bool Tli493d::recoverBus(void)
+{
+	tli493d::LockGuard guard(mConfigLock);
+	uint32_t start = micros();
+	bool ret = releaseBus();
+
+	resetSensor();
+	if (!writeConfig())
+		ret = false;
+	finishRecovery();
+
+	uint32_t duration = micros() - start;
+	if (duration > mInterface.recoveryTime)
+		mInterface.recoveryTime = duration;
+	return ret;
+}
+
+bool Tli493d::releaseBus(void)
+{
+	bool ret = true;
+
+	if (mSdaPin != NO_BUS_PIN && mSclPin != NO_BUS_PIN)
+	{
+		//the pins are handed over to the TwoWire-module again by begin()
+		tli493d::LockGuard busGuard(mBusLock);
+		mInterface.bus->end();
+		ret = clearBus();
+		mInterface.bus->begin();
+		tli493d::setTimeouts(&mInterface, mInterface.readTimeout, mInterface.writeTimeout);
+	}
+	return ret;
+}
+
+void Tli493d::finishRecovery(void)
+{
+	//re-arm also after a failed attempt, so that a dead sensor is only recovered after another
+	//TLI493D_MAX_BUS_ERRORS failed transfers (or the next timeout) instead of in every updateData()
+	mInterface.errorCount = 0;
+	mRecovering = false;
+	if (mInterface.recoveryCount < 0xFFFF)
+		mInterface.recoveryCount++;
+}
+
+uint16_t Tli493d::getBusErrors(void)
+{
+	return mInterface.busErrors;
+}
+
+uint16_t Tli493d::getRecoveryCount(void)
+{
+	return mInterface.recoveryCount;
+}
+
+uint32_t Tli493d::getRecoveryTime(void)
+{
+	return mInterface.recoveryTime;
+}
+
+void Tli493d::setBusTimeouts(uint16_t readTimeout, uint16_t writeTimeout)
+{
+	tli493d::setTimeouts(&mInterface, readTimeout, writeTimeout);
+}
+
+uint16_t Tli493d::getTimeouts(void)
+{
+	return mInterface.timeouts;
+}
+
+bool Tli493d::isRecovering(void)
+{
+	return mRecovering;
+}
+
+bool Tli493d::clearBus(void)
+{
+	//open drain: lines are driven low as output and released as input
+	pinMode(mSdaPin, INPUT_PULLUP);
+	pinMode(mSclPin, INPUT_PULLUP);
+	delayMicroseconds(TLI493D_RECOVERY_HALFCLOCK);
+
+	for (uint8_t i = 0; i < TLI493D_RECOVERY_CLOCKS && digitalRead(mSdaPin) == LOW; i++)
+	{
+		pinMode(mSclPin, OUTPUT);
+		digitalWrite(mSclPin, LOW);
+		delayMicroseconds(TLI493D_RECOVERY_HALFCLOCK);
+		pinMode(mSclPin, INPUT_PULLUP);
+		delayMicroseconds(TLI493D_RECOVERY_HALFCLOCK);
+	}
+
+	//STOP condition: rising edge on SDA while SCL is high
+	pinMode(mSclPin, OUTPUT);
+	digitalWrite(mSclPin, LOW);
+	delayMicroseconds(TLI493D_RECOVERY_HALFCLOCK);
+	pinMode(mSdaPin, OUTPUT);
+	digitalWrite(mSdaPin, LOW);
+	delayMicroseconds(TLI493D_RECOVERY_HALFCLOCK);
+	pinMode(mSclPin, INPUT_PULLUP);
+	delayMicroseconds(TLI493D_RECOVERY_HALFCLOCK);
+	pinMode(mSdaPin, INPUT_PULLUP);
+	delayMicroseconds(TLI493D_RECOVERY_HALFCLOCK);
+
+	return digitalRead(mSdaPin) == HIGH && digitalRead(mSclPin) == HIGH;
+}
+
+bool Tli493d::writeConfig(void)
+{
+	bool ret = true;
+	for (uint8_t chunk = 0; chunk < TLI493D_CONFIG_CHUNKS; chunk++)
+	{
+		if (!writeConfigChunk(chunk))
+		{
+			ret = false;
+			//do not wait for the deadline of every register on a hanging bus
+			if (mInterface.timedOut)
+				break;
+		}
+	}
+	return ret;
+}
+
+bool Tli493d::writeConfigChunk(uint8_t chunk)
+{
+	const uint8_t firstWakeUp = tli493d::regMasks[tli493d::XL].byteAdress;
+	const uint8_t wakeUpChunks = tli493d::CONFIG_REGISTER - firstWakeUp + 1;
+	uint8_t reg;
+
+	//MOD1 first, it selects the read protocol used by all following transfers
+	if (chunk == 0)
+	{
+		calcParity(tli493d::FP);
+		calcParity(tli493d::CP);
+		reg = tli493d::MOD1_REGISTER;
+	}
+	else if (chunk <= wakeUpChunks)
+		reg = firstWakeUp + chunk - 1;
+	else if (chunk == wakeUpChunks + 1)
+		reg = tli493d::MOD2_REGISTER;
+	else
+		reg = tli493d::CONFIG2_REGISTER;
+	return tli493d::writeOut(&mInterface, reg) == BUS_OK;
+}
+
+bool Tli493d::busReadStep(void *sensor, uint8_t chunk)
+{
+	Tli493d *self = (Tli493d *)sensor;
+	(void)chunk;
+	//the recovery takes several transfers, it is left to busConfigStep()
+	if (!self->mRecovering)
+		self->mStepError = self->readSample();
+	return true;
+}
+
+bool Tli493d::busConfigStep(void *sensor, uint8_t chunk)
+{
+	Tli493d *self = (Tli493d *)sensor;
+	tli493d::LockGuard guard(self->mConfigLock);
+
+	//a recovery prepends the release of the bus and the reset, one chunk each
+	if (chunk == 0)
+		self->mStepRecovery = self->mRecovering;
+	if (self->mStepRecovery)
+	{
+		if (chunk == 0)
+		{
+			self->releaseBus();
+			return false;
+		}
+		if (chunk == 1)
+		{
+			self->resetSensor();
+			return false;
+		}
+		chunk -= 2;
+	}
+
+	self->writeConfigChunk(chunk);
+	if (chunk + 1 < TLI493D_CONFIG_CHUNKS)
+		return false;
+	if (self->mStepRecovery)
+		self->finishRecovery();
+	return true;
+}
+
+Tli493d_Error_t Tli493d::getStepError(void)
+{
+	return mStepError;
+}
+
 void Tli493d::setRegBits(uint8_t regMaskIndex, uint8_t data)
 {
 	if (regMaskIndex < TLI493D_NUM_OF_REGMASKS)
@@ -512,6 +1188,11 @@ uint8_t Tli493d::getRegBits(uint8_t regMaskIndex)
 }
 
 void Tli493d::calcParity(uint8_t regMaskIndex)
+{
+	calcParity(mInterface.regData, regMaskIndex);
+}
+
+void Tli493d::calcParity(uint8_t *regData, uint8_t regMaskIndex)
 {
 	// regMaskIndex should be FP or CP, both odd parity
 	// FP: parity of register 11 and the upper 3 bits (PRD) of 13
@@ -525,12 +1206,13 @@ void Tli493d::calcParity(uint8_t regMaskIndex)
 	// set parity bit to 1
 	// algorithm will calculate an even parity and replace this bit,
 	// so parity becomes odd
-	setRegBits(regMaskIndex, 1);
+	const tli493d::RegMask_t *mask = &tli493d::regMasks[regMaskIndex];
+	tli493d::setToRegs(mask, regData, 1);
 
 	if (regMaskIndex == tli493d::FP)
 	{
-		y ^= mInterface.regData[17];
-		y ^= (mInterface.regData[19] >> 5); //upper 3 bits
+		y ^= regData[17];
+		y ^= (regData[19] >> 5); //upper 3 bits
 	}
 	else if (regMaskIndex == tli493d::CP)
 	{
@@ -538,19 +1220,19 @@ void Tli493d::calcParity(uint8_t regMaskIndex)
 		for (i = 7; i <= 12; i++)
 		{
 			// combine XL through ZH
-			y ^= mInterface.regData[i];
+			y ^= regData[i];
 		}
-		y ^= (mInterface.regData[13] & 0x7F); //ignoring WA
-		y ^= (mInterface.regData[14] & 0x3F); //ignoring TST
-		y ^= (mInterface.regData[15] & 0x3F); //ignoring PH
-		y ^= mInterface.regData[16];
+		y ^= (regData[13] & 0x7F); //ignoring WA
+		y ^= (regData[14] & 0x3F); //ignoring TST
+		y ^= (regData[15] & 0x3F); //ignoring PH
+		y ^= regData[16];
 	}
 	// combine all bits of this byte (assuming each register is one byte)
 	y = y ^ (y >> 1);
 	y = y ^ (y >> 2);
 	y = y ^ (y >> 4);
 	// parity is in the LSB of y
-	setRegBits(regMaskIndex, y & 0x01);
+	tli493d::setToRegs(mask, regData, y & 0x01);
 }
 
 int16_t Tli493d::concatResults(uint8_t upperByte, uint8_t lowerByte, bool isB)
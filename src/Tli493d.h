@@ -38,18 +38,46 @@
 #include <Wire.h>
 #include "./util/BusInterface.h"
 #include "./util/Tli493d_conf.h"
+#include "./util/Statistics.h"
+#include "./util/IntMath.h"
+#include "./util/Lock.h"
 
 #define NO_POWER_PIN -1
+#define NO_BUS_PIN -1
 
 typedef enum Tli493d_Error
 {
 	TLI493D_NO_ERROR = 0,
 	TLI493D_BUS_ERROR = 1,
-	TLI493D_FRAME_ERROR = 2
+	TLI493D_FRAME_ERROR = 2,
+	TLI493D_TIMEOUT_ERROR = 3		//a transfer missed its deadline, the next updateData() recovers the bus
 } Tli493d_Error_t;
 
+typedef enum Tli493d_SelfTest
+{
+	TLI493D_SELFTEST_OK = 0x00,
+	TLI493D_SELFTEST_BUS = 0x01,		//a transfer failed
+	TLI493D_SELFTEST_PARITY = 0x02,		//fuse or configuration parity flag not set
+	TLI493D_SELFTEST_FRAME = 0x04,		//frame counter did not advance between measurements
+	TLI493D_SELFTEST_TEMP = 0x08,		//temperature outside of the operating range
+	TLI493D_SELFTEST_RANGE = 0x10		//X2/X4 scaling does not match the full range measurement
+} Tli493d_SelfTest_t;
+
+typedef struct Tli493d_WakeUpTuning
+{
+	int16_t threshold[6];	//xh, xl, yh, yl, zh, zl in LSB
+	int16_t temp;			//raw temperature value while tuning
+	uint16_t samples;		//number of samples taken
+	uint8_t falseWakeExp;	//target false wake-up rate 10^-falseWakeExp per measurement
+	uint8_t range;			//measurement range the thresholds belong to
+} Tli493d_WakeUpTuning_t;
+
 class Tli493d
 {
+	friend class Tli493dPair;
+	friend class Tli493dArray;
+	friend class Tli493dDiscovery;
+
   public:
 	enum TypeAddress_e
 	{
@@ -224,6 +252,77 @@ class Tli493d
     bool setWakeUpThresholdMT(float xh, float xl, float yh, float yl, float zh,
                             float zl);
 
+	/**
+	 * @brief Enables the tracking wake-up window. Whenever updateData() reads a value outside of the current wake-up window,
+	 * 		  e.g. after a wake-up interrupt, the window is recentred around the new value as [value - delta, value + delta]
+	 * 		  for each axis. Thus interrupts are only sent when the field changes, even if the magnet settles at a new rest position.
+	 * 		  The window is written in one burst together with the configuration register (CP parity).
+	 * @param delta Half width of the window in LSB [1,1024]; the window must not exceed half the output range
+	 * @return true if delta is valid, otherwise false without taking effect
+	 */
+	bool enableWakeUpTracking(int16_t delta);
+
+	/**
+	 * @brief Disables the tracking wake-up window; the current window stays configured.
+	 */
+	void disableWakeUpTracking(void);
+
+	/**
+	 * @brief Tunes the wake-up window to the noise of the sensor. The magnet has to be at rest. The sensor takes the given number
+	 * 		  of measurements in master controlled mode, estimates mean and noise per axis with online statistics and programs the
+	 * 		  narrowest window around the mean, for which the probability of a false wake-up per measurement stays below 10^-falseWakeExp
+	 * 		  (assuming gaussian noise). The previous configuration is restored afterwards; wake-up is not enabled by this function.
+	 * @param samples Number of measurements, default TLI493D_TUNE_SAMPLES
+	 * @param falseWakeExp Target false wake-up rate as negative power of ten [1,6], default 4
+	 * @return true if the window could be programmed within half the output range, otherwise false
+	 */
+	bool autoTuneWakeUp(uint16_t samples = TLI493D_TUNE_SAMPLES, uint8_t falseWakeExp = 4);
+
+	/**
+	 * @brief Returns the result of the last autoTuneWakeUp(), e.g. to store it in non-volatile memory
+	 */
+	void getWakeUpTuning(Tli493d_WakeUpTuning_t &tuning);
+
+	/**
+	 * @brief Programs a wake-up window stored by getWakeUpTuning()
+	 * @return true if the window was written, false if it belongs to another measurement range or on bus error
+	 */
+	bool setWakeUpTuning(const Tli493d_WakeUpTuning_t &tuning);
+
+	/**
+	 * @brief Repeats autoTuneWakeUp() with the previous parameters if the temperature measured by the last updateData()
+	 * 		  differs by more than TLI493D_TUNE_TEMP_DELTA from the temperature while tuning. Temperature measurement must be enabled.
+	 * @return true if the window was tuned again, otherwise false
+	 */
+	bool retuneWakeUp(void);
+
+	/**
+	 * @brief Sets the window of the software wake-up in LSB [-2048,2047]. In contrast to the hardware wake-up this window
+	 * 		  is not limited to half the output range, has full 12 bit resolution and works in all ranges including EXTRASHORT.
+	 * 		  The window is checked by checkSoftWakeUp(); by default it covers the whole range, so no event is raised.
+	 * @return true if the thresholds are valid, otherwise false without taking effect
+	 */
+	bool setSoftWakeUpThresholdLSB(int16_t xh, int16_t xl, int16_t yh, int16_t yl, int16_t zh, int16_t zl);
+
+	/**
+	 * @brief Sets the window of the software wake-up in mT for the current measurement range. See setSoftWakeUpThresholdLSB().
+	 * @return true if the thresholds are valid, otherwise false without taking effect
+	 */
+	bool setSoftWakeUpThresholdMT(float xh, float xl, float yh, float yl, float zh, float zl);
+
+	/**
+	 * @brief Software emulation of the wake-up function. Reads only the six bytes of Bx, By and Bz and compares them against
+	 * 		  the window set by setSoftWakeUpThresholdLSB() in integer math. Intended for LOWPOWERMODE with interrupts enabled:
+	 * 		  the sensor sends /INT after every measurement and this function is called from the interrupt.
+	 * 		  Compared to the hardware wake-up the microcontroller wakes up once per update period (one 6 byte read, about 200us
+	 * 		  at 400kHz) instead of only on window exit, so the energy of the microcontroller scales with the update rate.
+	 * 		  Latency is the same: one update period plus the read-out. Afterwards getX(), getY() and getZ() return the new values.
+	 * 		  The config lock is not taken. With a bus lock from setLocks() the function is task-only: let the interrupt
+	 * 		  notify a task which calls it, since an RTOS mutex must not be taken in an interrupt.
+	 * @return true if any of Bx, By or Bz is outside of its window, false if inside or on bus error
+	 */
+	bool checkSoftWakeUp(void);
+
     /**
 	 * @brief Checks if WA bit is set. When not interrupt configuration is as specified by the CA and INT bits.
 	 */
@@ -263,6 +362,25 @@ class Tli493d
 	 */
 	Tli493d_Error updateData(void);
 
+	/**
+	 * @brief Keeps online statistics of Bx, By, Bz and temperature in raw LSB: Welford mean and variance, min, max, sample count
+	 * 		  and an optional histogram (see tli493d::setHistogram()). Each updateData() adds a sample in O(1).
+	 * @param stats Storage for the statistics, which is cleared; NULL stops collecting statistics
+	 */
+	void setStatistics(tli493d::Statistics_t *stats);
+
+	/**
+	 * @brief Clears the statistics, the histogram configuration is kept. Safe against updateData() in an interrupt.
+	 */
+	void resetStatistics(void);
+
+	/**
+	 * @brief Copies the statistics consistently, also when updateData() is called from an interrupt
+	 * @param snapshot Copy of the statistics
+	 * @return false if no statistics are collected, otherwise true
+	 */
+	bool getStatistics(tli493d::Statistics_t &snapshot);
+
 	/**
 	 * @return the Cartesian x-coordinate
 	 */
@@ -291,17 +409,127 @@ class Tli493d
 	 */
 	float getPolar(void);
 
+	/**
+	 * @return the azimuth angle atan2(y, x) as binary angle, full circle is 65536, in integer math
+	 */
+	tli493d::Bam_t getAzimuthBam(void);
+
+	/**
+	 * @return the polar angle atan2(z, sqrt(x^2+y^2)) as binary angle in [-16384,16384] (cast to int16_t), in integer math
+	 */
+	tli493d::Bam_t getPolarBam(void);
+
 	/**
 	 * @return the temperature value
 	 */
 	float getTemp(void);
 
+	/**
+	 * @return the raw x value in LSB [-2048,2047], for processing in integer math
+	 */
+	int16_t getRawX(void);
+	/**
+	 * @return the raw y value in LSB [-2048,2047]
+	 */
+	int16_t getRawY(void);
+	/**
+	 * @return the raw z value in LSB [-2048,2047]
+	 */
+	int16_t getRawZ(void);
+	/**
+	 * @return the raw temperature value in LSB
+	 */
+	int16_t getRawTemp(void);
+
+	/**
+	 * @brief Copies x, y, z and temperature of the same updateData() call. Never blocks: if updateData() runs in another
+	 * 		  task or an interrupt meanwhile, the copy is repeated.
+	 * @param raw Returns x, y and z in LSB [-2048,2047] and the temperature in LSB
+	 */
+	void getRawData(int16_t (&raw)[4]);
+
+	/**
+	 * @brief Enables thread-safe access for RTOS builds; both locks are optional (NULL). The bus lock is held for each
+	 * 		  single transfer and can be shared with other devices on the same TwoWire. The config lock is held by every
+	 * 		  function which changes the configuration and has to be recursive, since these functions call each other.
+	 * 		  updateData() only takes the bus lock (and the config lock for wake-up tracking and bus recovery); readers of
+	 * 		  getRawData() never take a lock. Only one task should call updateData(). With a bus lock, checkSoftWakeUp()
+	 * 		  must not be called from an interrupt any more.
+	 * 		  Call before begin() or when the sensor is not in use.
+	 */
+	void setLocks(const tli493d::Lock_t *busLock, const tli493d::Lock_t *configLock);
+
 	/**
 	 * @brief Resets the sensor
 	 */
 	void resetSensor(void);
 
 	void readDiagnosis(uint8_t (&diag)[7]);
+
+	/**
+	 * @brief Runs a self test without external magnet. The sensor is switched to master controlled mode and cycles through
+	 * 		  the ranges FULL, SHORT and EXTRASHORT and through the temperature and Bz channel enables. For each step the
+	 * 		  fuse and configuration parity flags and the progress of the frame counter are checked. Temperature has to be
+	 * 		  within the operating range, and if a field of at least TLI493D_SELFTEST_MIN_LSB is present, the X2 and X4 readings
+	 * 		  have to be twice and four times the full range reading. Wake-up is disabled during the test.
+	 * 		  The test takes a fixed number of bus transactions (at most 37). Afterwards the previous configuration is restored.
+	 * @return TLI493D_SELFTEST_OK or a combination of the flags in @ref Tli493d_SelfTest
+	 */
+	uint8_t selfTest(void);
+
+	/**
+	 * @brief Sets the pins of SDA and SCL, so that a stuck bus can be released by clocking it manually.
+	 * 		  Without these pins recoverBus() can only reset and reconfigure the sensor.
+	 * @param sdaPin Pin number of the SDA line
+	 * @param sclPin Pin number of the SCL line
+	 */
+	void setBusPins(int sdaPin, int sclPin);
+
+	/**
+	 * @brief Releases a stuck I2C bus and restores the sensor. If the sensor holds SDA low, up to 9 clock pulses are
+	 * 		  generated followed by a STOP condition. Afterwards the sensor is reset and the current configuration is written again.
+	 * 		  updateData() calls this function automatically after TLI493D_MAX_BUS_ERRORS consecutive failed transfers.
+	 * 		  The error counter is cleared by every attempt, so a sensor which stays dead is retried only after another
+	 * 		  TLI493D_MAX_BUS_ERRORS failed transfers.
+	 * @return true if the bus is free and the configuration could be written, otherwise false
+	 */
+	bool recoverBus(void);
+
+	/**
+	 * @return the total number of failed bus transfers
+	 */
+	uint16_t getBusErrors(void);
+
+	/**
+	 * @return the number of bus recoveries carried out
+	 */
+	uint16_t getRecoveryCount(void);
+
+	/**
+	 * @return the duration of the longest bus recovery in us
+	 */
+	uint32_t getRecoveryTime(void);
+
+	/**
+	 * @brief Sets the deadlines of the bus transfers. A transfer which misses its deadline fails, updateData() returns
+	 * 		  TLI493D_TIMEOUT_ERROR and the sensor enters the recovery state: the next updateData() calls recoverBus() first.
+	 * 		  Thus one call of updateData() takes at most the recovery (bus clearing, reset and one timed out write) plus
+	 * 		  one read. On cores with WIRE_HAS_TIMEOUT a hanging Wire call is aborted by the core; other cores can only
+	 * 		  detect late transfers and missing data.
+	 * @param readTimeout Budget of a read in us, 0 disables the deadline; default TLI493D_READ_TIMEOUT
+	 * @param writeTimeout Budget of a write in us, 0 disables the deadline; default TLI493D_WRITE_TIMEOUT
+	 */
+	void setBusTimeouts(uint16_t readTimeout, uint16_t writeTimeout);
+
+	/**
+	 * @return the number of transfers which missed their deadline
+	 */
+	uint16_t getTimeouts(void);
+
+	/**
+	 * @return true if a transfer missed its deadline and the bus has not been recovered yet
+	 */
+	bool isRecovering(void);
 	
 		/**
 	 * @brief Enables interrupts
@@ -324,6 +552,27 @@ class Tli493d
 	 */
 	void disableCollisionAvoidance(void);
 
+	/**
+	 * @brief Step function for tli493d::BusScheduler_t, reads the sensor like updateData() in one chunk, but never
+	 * 		  recovers the bus: while isRecovering() the read is skipped until a job with busConfigStep() has run.
+	 * 		  The result is available with getStepError().
+	 * 		  Pass the sensor as context, e.g. initBusJob(&job, Tli493d::busReadStep, &sensor, ...).
+	 */
+	static bool busReadStep(void *sensor, uint8_t chunk);
+
+	/**
+	 * @brief Step function for tli493d::BusScheduler_t, writes the local configuration to the sensor with one register per
+	 * 		  chunk (TLI493D_CONFIG_CHUNKS transfers of 2 bytes), so that other clients of the bus wait only for a short transfer.
+	 * 		  If the sensor isRecovering() when the job starts, the job carries out recoverBus() in chunks: first the release
+	 * 		  of the bus, then the reset, then the configuration. getRecoveryTime() only covers recoverBus().
+	 */
+	static bool busConfigStep(void *sensor, uint8_t chunk);
+
+	/**
+	 * @return the result of the last read of busReadStep(); a skipped read keeps the previous result
+	 */
+	Tli493d_Error_t getStepError(void);
+
 
   protected:
 	tli493d::BusInterface_t mInterface;
@@ -345,17 +594,119 @@ class Tli493d
 	const TypeAddress_e mProductType;
 	int mPowerPin;
 	bool mPowerLevel;
+	int mSdaPin;
+	int mSclPin;
 	int16_t mXdata;
 	int16_t mYdata;
 	int16_t mZdata;
 	int16_t mTempdata;
 	float mBMult = TLI493D_B_MULT_FULL;
+	int16_t mWuDelta;
+	Tli493d_WakeUpTuning_t mTuning;
+	tli493d::Statistics_t *mStats;
+	int16_t mSoftWuHigh[3];
+	int16_t mSoftWuLow[3];
+	bool mRecovering;
+	bool mStepRecovery;			//the running busConfigStep() job recovers the bus
+	Tli493d_Error_t mStepError;
+	const tli493d::Lock_t *mBusLock;
+	const tli493d::Lock_t *mConfigLock;
+	volatile uint16_t mSampleSeq;	//odd while updateData() writes the values
 
 	/**
 	 * @brief Sets FP (fuse parity) and CP (configuration parity)
 	 */
 	void calcParity(uint8_t regMaskIndex);
 
+	/**
+	 * @brief Sets FP or CP in a register image, e.g. the shared image of Tli493dArray
+	 */
+	static void calcParity(uint8_t *regData, uint8_t regMaskIndex);
+
+	/**
+	 * @brief Switches on VDD if a power pin is set
+	 */
+	void powerOn(void);
+
+	/**
+	 * @brief Initializes the local register copy with the reset values of the product type, without bus transfers
+	 */
+	void initSensor(TwoWire &bus, TypeAddress_e slaveAddress);
+
+	/**
+	 * @brief Generates clock pulses on SCL until SDA is released, followed by a STOP condition
+	 * @return true if SDA is high afterwards
+	 */
+	bool clearBus(void);
+
+	/**
+	 * @brief Clears the bus with clearBus() if the bus pins are set and hands the pins back to the TwoWire-module
+	 * @return false if SDA or SCL stay low
+	 */
+	bool releaseBus(void);
+
+	/**
+	 * @brief Ends a recovery: clears the error counter and the recovery state and counts the recovery
+	 */
+	void finishRecovery(void);
+
+	/**
+	 * @brief Writes all configuration registers from the local register copy to the sensor
+	 * @return true if all registers were written successfully
+	 */
+	bool writeConfig(void);
+
+	/**
+	 * @brief Writes one chunk of writeConfig(): 0 is MOD1, then the wake-up registers and CONFIG, then MOD2 and CONFIG2.
+	 * 		  The parity bits are updated with chunk 0.
+	 * @return true if the register was written successfully
+	 */
+	bool writeConfigChunk(uint8_t chunk);
+
+	/**
+	 * @brief Stores the wake-up thresholds into the local register copy
+	 * @param th Thresholds xh, xl, yh, yl, zh, zl in LSB [-2048,2047]
+	 */
+	void setWakeUpRegs(const int16_t (&th)[6]);
+
+	/**
+	 * @brief Returns a wake-up threshold in LSB from the local register copy
+	 * @param msbIndex Register mask index of the threshold MSBs, e.g. XH
+	 * @param lsbIndex Register mask index of the threshold LSBs, e.g. XH2
+	 */
+	int16_t getWakeUpReg(uint8_t msbIndex, uint8_t lsbIndex);
+
+	/**
+	 * @brief Reads the measurement registers (7 bytes) and stores the values, without bus recovery, statistics and
+	 * 		  wake-up tracking; for internal reads, e.g. of selfTest() and autoTuneWakeUp()
+	 * @return TLI493D_NO_ERROR, TLI493D_BUS_ERROR or TLI493D_TIMEOUT_ERROR
+	 */
+	Tli493d_Error_t readData(void);
+
+	/**
+	 * @brief Reads with readData() and feeds the statistics and the wake-up tracking. A timeout or
+	 * 		  TLI493D_MAX_BUS_ERRORS failed transfers set the recovery state, but the bus is not recovered here.
+	 */
+	Tli493d_Error_t readSample(void);
+
+	/**
+	 * @brief Reads only Bx, By and Bz (6 bytes) without diagnosis and temperature
+	 * @return true if the transfer was successful
+	 */
+	bool readField(void);
+
+	/**
+	 * @brief Recentres the wake-up window around the current values if any of them is outside of the window
+	 */
+	void trackWakeUp(void);
+
+	/**
+	 * @brief Part of selfTest(): takes two measurements and checks parity flags and frame counter
+	 * @param raw Returns the x, y and z values of the second measurement
+	 * @return combination of the flags in @ref Tli493d_SelfTest
+	 */
+	uint8_t selfTestStep(int16_t (&raw)[3]);
+
 	/**
 	 * @brief Concatenates the upper bits and lower bits of magnetic or temperature measurements
 	 */
@@ -0,0 +1,354 @@
+/** @file Tli493dArray.cpp
+ *  @brief Common configuration of many TLI493D sensors with few bus transactions
+ */
+
+#include "Tli493dArray.h"
+#include "./util/RegMask.h"
+#include "./util/BusInterface2.h"
+
+Tli493dArray::Tli493dArray(Tli493d *const sensors[], uint8_t count) : mSensors(sensors), mCount(count), mRange(Tli493d::FULL), mBeginTime(0), mReset(true), mHealth(NULL), mCallback(NULL), mSlots(count), mNext(0), mProbe(0), mLast(count), mCycle(0)
+{
+	for (uint8_t i = 0; i < TLI493D_NUM_REG; i++)
+	{
+		mImage[i] = tli493d::resetValues[i];
+	}
+	//1-byte read protocol and the access mode of the first sensor, as set by Tli493d::begin()
+	setImageBits(tli493d::PR, 1);
+	setAccessMode(count > 0 ? sensors[0]->mMode : Tli493d::MASTERCONTROLLEDMODE);
+	commitImage();
+}
+
+bool Tli493dArray::begin(bool reset)
+{
+	return begin(NULL, reset);
+}
+
+bool Tli493dArray::begin(TwoWire *const buses[], bool reset)
+{
+	uint32_t start = micros();
+	mReset = reset;
+
+	//one power-up delay for all sensors
+	for (uint8_t i = 0; i < mCount; i++)
+	{
+		mSensors[i]->powerOn();
+	}
+	delay(100);
+
+	for (uint8_t i = 0; i < mCount; i++)
+	{
+		TwoWire &bus = buses != NULL ? *buses[i] : Wire;
+		mSensors[i]->initSensor(bus, mSensors[i]->mProductType);
+
+		//begin and reset each bus only once, the general call resets all sensors on it
+		bool first = true;
+		for (uint8_t j = 0; j < i; j++)
+		{
+			if (mSensors[j]->mInterface.bus == &bus)
+				first = false;
+		}
+		if (first)
+		{
+			bus.begin();
+			if (reset)
+				mSensors[i]->resetSensor();
+		}
+	}
+
+	bool ret = writeConfig();
+	delay(TLI493D_STARTUPDELAY);
+	mBeginTime = micros() - start;
+	return ret;
+}
+
+bool Tli493dArray::setAccessMode(Tli493d::AccessMode_e mode)
+{
+	if (mode == 2 || mode > 3)
+		return false;
+	//trigger on read of address 00h in master controlled mode, as Tli493d::setAccessMode()
+	setImageBits(tli493d::TRIG, mode == Tli493d::MASTERCONTROLLEDMODE ? 1 : 0);
+	setImageBits(tli493d::MODE, mode);
+	mMode = mode;
+	return true;
+}
+
+void Tli493dArray::setTrigger(uint8_t trigger)
+{
+	if (trigger > 3u || mMode == Tli493d::LOWPOWERMODE)
+		return;
+	setImageBits(tli493d::TRIG, trigger);
+}
+
+void Tli493dArray::enableInterrupt(void)
+{
+	setImageBits(tli493d::INT, 0);
+}
+
+void Tli493dArray::disableInterrupt(void)
+{
+	setImageBits(tli493d::INT, 1);
+}
+
+void Tli493dArray::enableCollisionAvoidance(void)
+{
+	setImageBits(tli493d::CA, 0);
+}
+
+void Tli493dArray::disableCollisionAvoidance(void)
+{
+	setImageBits(tli493d::CA, 1);
+}
+
+void Tli493dArray::enableTemp(void)
+{
+	setImageBits(tli493d::DT, 0);
+}
+
+void Tli493dArray::disableTemp(void)
+{
+	setImageBits(tli493d::DT, 1);
+}
+
+void Tli493dArray::enableBz(void)
+{
+	setImageBits(tli493d::AM, 0);
+}
+
+void Tli493dArray::disableBz(void)
+{
+	setImageBits(tli493d::AM, 1);
+}
+
+void Tli493dArray::setUpdateRate(uint8_t updateRate)
+{
+	if (updateRate > 7)
+		updateRate = 7;
+	setImageBits(tli493d::PRD, updateRate);
+}
+
+bool Tli493dArray::setMeasurementRange(Tli493d::Range_e range)
+{
+	if (range == 2 || range > 3)
+		return false;
+	//X4 cannot be used together with wake-up
+	if (range == Tli493d::EXTRASHORT && tli493d::getFromRegs(&tli493d::regMasks[tli493d::WU], mImage))
+		return false;
+	setImageBits(tli493d::X2, range & 0x01);
+	setImageBits(tli493d::X4, (range & 0x02) >> 1);
+	mRange = range;
+	return true;
+}
+
+bool Tli493dArray::writeConfig(void)
+{
+	commitImage();
+
+	bool ret = true;
+	for (uint8_t i = 0; i < mCount; i++)
+	{
+		if (!writeSensor(mSensors[i]))
+			ret = false;
+	}
+	return ret;
+}
+
+void Tli493dArray::setHealth(tli493d::Health_t *health)
+{
+	mHealth = health;
+	if (health == NULL)
+		return;
+	for (uint8_t i = 0; i < mCount; i++)
+	{
+		tli493d::initHealth(&health[i]);
+	}
+}
+
+void Tli493dArray::setHealthCallback(Tli493d_HealthCallback_t callback)
+{
+	mCallback = callback;
+}
+
+void Tli493dArray::setSlots(uint8_t slots)
+{
+	mSlots = slots;
+}
+
+uint8_t Tli493dArray::updateData(void)
+{
+	uint8_t good = 0;
+	uint8_t slots = mSlots;
+
+	if (mHealth != NULL && ++mCycle >= TLI493D_HEALTH_PROBE_CYCLES)
+	{
+		mCycle = 0;
+		uint8_t index = findSensor(mProbe, true);
+		if (index < mCount && slots > 0)
+		{
+			mProbe = index + 1;
+			slots--;
+			if (readSensor(index))
+				good++;
+		}
+	}
+
+	for (uint8_t slot = 0; slot < slots; slot++)
+	{
+		uint8_t index = findSensor(mNext, false);
+		if (index >= mCount)
+			break;
+		mNext = index + 1;
+		if (readSensor(index))
+			good++;
+	}
+	return good;
+}
+
+bool Tli493dArray::isExcluded(uint8_t index)
+{
+	return mHealth != NULL && index < mCount && mHealth[index].excluded;
+}
+
+uint32_t Tli493dArray::getBeginTime(void)
+{
+	return mBeginTime;
+}
+
+uint8_t Tli493dArray::getCount(void)
+{
+	return mCount;
+}
+
+Tli493d &Tli493dArray::operator[](uint8_t index)
+{
+	return *mSensors[index];
+}
+
+void Tli493dArray::setImageBits(uint8_t regMaskIndex, uint8_t data)
+{
+	tli493d::setToRegs(&tli493d::regMasks[regMaskIndex], mImage, data);
+}
+
+bool Tli493dArray::writeSensor(Tli493d *sensor)
+{
+	const uint8_t first = tli493d::regMasks[tli493d::XL].byteAdress;
+	tli493d::LockGuard guard(sensor->mConfigLock);
+
+	uint8_t address = sensor->getRegBits(tli493d::IICadr);
+	for (uint8_t i = first; i < first + TLI493D_CONFIG_BURST; i++)
+	{
+		sensor->mInterface.regData[i] = mCommitted[i];
+	}
+	for (uint8_t i = tli493d::MOD2_REGISTER; i < tli493d::MOD2_REGISTER + TLI493D_CONFIG_TAIL; i++)
+	{
+		sensor->mInterface.regData[i] = mCommitted[i];
+	}
+	sensor->setRegBits(tli493d::IICadr, address);
+	//IICadr has two bits: 01 and 10 change the parity, 11 does not
+	if ((address ^ (address >> 1)) & 0x01)
+		sensor->setRegBits(tli493d::FP, !sensor->getRegBits(tli493d::FP));
+
+	sensor->mMode = mCommittedMode;
+	switch (mCommittedRange)
+	{
+		case Tli493d::FULL:			sensor->mBMult = TLI493D_B_MULT_FULL; break;
+		case Tli493d::SHORT:		sensor->mBMult = TLI493D_B_MULT_X2; break;
+		case Tli493d::EXTRASHORT:	sensor->mBMult = TLI493D_B_MULT_X4; break;
+	}
+	//the reserved register 12h between MOD1 and MOD2 is never written: the burst ends at MOD1 and MOD2 and CONFIG2
+	//follow in a second transfer, instead of reading 12h at begin() to write it back
+	bool ret = tli493d::writeOut(&sensor->mInterface, first, TLI493D_CONFIG_BURST) == BUS_OK;
+	if (tli493d::writeOut(&sensor->mInterface, tli493d::MOD2_REGISTER, TLI493D_CONFIG_TAIL) != BUS_OK)
+		ret = false;
+	return ret;
+}
+
+bool Tli493dArray::readSensor(uint8_t index)
+{
+	Tli493d *sensor = mSensors[index];
+	//no recovery by the sensor itself: its general call would reset all sensors on the bus
+	bool ok = sensor->readSample() == TLI493D_NO_ERROR;
+	bool consecutive = mLast == index;
+	mLast = index;
+	if (sensor->mRecovering)
+		recoverBus(index);
+	if (mHealth == NULL)
+		return ok;
+
+	tli493d::Health_t *health = &mHealth[index];
+	uint8_t faults = tli493d::HEALTH_OK;
+	if (!ok)
+	{
+		faults |= tli493d::HEALTH_BUS;
+	}
+	else
+	{
+		if (!sensor->getRegBits(tli493d::FF) || !sensor->getRegBits(tli493d::CF))
+			faults |= tli493d::HEALTH_PARITY;
+		uint8_t frame = sensor->getRegBits(tli493d::FRM);
+		if (frame == health->frame && !consecutive)
+			faults |= tli493d::HEALTH_STALE;
+		health->frame = frame;
+	}
+
+	uint8_t event = tli493d::addToHealth(health, faults);
+	if (event != tli493d::HEALTH_NO_EVENT && mCallback != NULL)
+		mCallback(index, event, health->score);
+	return ok;
+}
+
+void Tli493dArray::recoverBus(uint8_t index)
+{
+	Tli493d *sensor = mSensors[index];
+	uint32_t start = micros();
+
+	//the last written configuration, setter changes since then wait for writeConfig()
+	sensor->releaseBus();
+	if (mReset)
+	{
+		sensor->resetSensor();
+		for (uint8_t i = 0; i < mCount; i++)
+		{
+			if (mSensors[i]->mInterface.bus != sensor->mInterface.bus)
+				continue;
+			writeSensor(mSensors[i]);
+			//the frame counter restarts with the reset
+			if (mHealth != NULL)
+				mHealth[i].frame = TLI493D_HEALTH_NO_FRAME;
+		}
+	}
+	else
+	{
+		writeSensor(sensor);
+	}
+	sensor->finishRecovery();
+
+	uint32_t duration = micros() - start;
+	if (duration > sensor->mInterface.recoveryTime)
+		sensor->mInterface.recoveryTime = duration;
+}
+
+void Tli493dArray::commitImage(void)
+{
+	//CP does not depend on the device, FP is computed for IICadr = 0 and flipped for an odd number of address bits
+	setImageBits(tli493d::IICadr, 0);
+	Tli493d::calcParity(mImage, tli493d::CP);
+	Tli493d::calcParity(mImage, tli493d::FP);
+
+	for (uint8_t i = 0; i < TLI493D_NUM_REG; i++)
+	{
+		mCommitted[i] = mImage[i];
+	}
+	mCommittedMode = mMode;
+	mCommittedRange = mRange;
+}
+
+uint8_t Tli493dArray::findSensor(uint8_t start, bool excluded)
+{
+	for (uint8_t i = 0; i < mCount; i++)
+	{
+		uint8_t index = (start + i) % mCount;
+		if (isExcluded(index) == excluded)
+			return index;
+	}
+	return mCount;
+}
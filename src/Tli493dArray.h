@@ -0,0 +1,160 @@
+/** @file Tli493dArray.h
+ *  @brief Common configuration of many TLI493D sensors with few bus transactions
+ *
+ *	All sensors of an array share one configuration. The register image is computed once, only the per-device fields
+ *	are patched: the address bits IICadr and the fuse parity FP, which covers them. Each sensor is then configured with
+ *	two bursts around the reserved register 12h, instead of one transfer per register and setter. begin() powers all
+ *	sensors up together and resets each bus once with the general call, so the bring-up does not grow with the delays
+ *	of the single sensors.
+ */
+
+#ifndef TLI493D_ARRAY_H_INCLUDED
+#define TLI493D_ARRAY_H_INCLUDED
+
+#include "Tli493d.h"
+#include "./util/Health.h"
+
+/**
+ * @brief Called when a sensor is excluded from or readmitted to the cycle of updateData()
+ * @param index Index of the sensor in the array
+ * @param event tli493d::HEALTH_EXCLUDED or tli493d::HEALTH_READMITTED
+ * @param score Health score of the sensor
+ */
+typedef void (*Tli493d_HealthCallback_t)(uint8_t index, uint8_t event, uint8_t score);
+
+class Tli493dArray
+{
+  public:
+	/**
+	 * @brief Constructor of the array. The sensors must not be started with begin(); each address (TLI493D_A0 to
+	 * 		  TLI493D_A3) may only be used once per bus. The configuration is the default of Tli493d.
+	 * @param sensors Array of the sensors, must stay valid
+	 * @param count Number of sensors
+	 */
+	Tli493dArray(Tli493d *const sensors[], uint8_t count);
+
+	/**
+	 * @brief Starts all sensors on Wire, see begin(TwoWire *const buses[], bool)
+	 */
+	bool begin(bool reset = true);
+
+	/**
+	 * @brief Powers up all sensors, resets each bus once with the general call if reset is true and writes the
+	 * 		  configuration with two bursts per sensor. The general call also resets other devices on the bus which
+	 * 		  answer to it; in that case set reset to false.
+	 * @param buses Bus of each sensor, e.g. several TwoWire modules for more than four sensors; NULL for Wire
+	 * @return true if all sensors were configured
+	 */
+	bool begin(TwoWire *const buses[], bool reset = true);
+
+	/**
+	 * @brief The following functions only change the shared configuration; writeConfig() sends it to all sensors
+	 */
+	bool setAccessMode(Tli493d::AccessMode_e mode);
+	void setTrigger(uint8_t trigger);
+	void enableInterrupt(void);
+	void disableInterrupt(void);
+	void enableCollisionAvoidance(void);
+	void disableCollisionAvoidance(void);
+	void enableTemp(void);
+	void disableTemp(void);
+	void enableBz(void);
+	void disableBz(void);
+	void setUpdateRate(uint8_t updateRate);
+	bool setMeasurementRange(Tli493d::Range_e range);
+
+	/**
+	 * @brief Writes the shared configuration to all sensors, two bursts per sensor
+	 * @return true if all sensors were configured
+	 */
+	bool writeConfig(void);
+
+	/**
+	 * @brief Enables the health scoring
+	 * @param health Array with one entry per sensor, e.g. tli493d::Health_t health[4]; NULL disables the scoring
+	 */
+	void setHealth(tli493d::Health_t *health);
+
+	/**
+	 * @brief Sets the function which reports exclusions and readmissions
+	 */
+	void setHealthCallback(Tli493d_HealthCallback_t callback);
+
+	/**
+	 * @brief Sets the number of reads per cycle of updateData(), default one per sensor. The slots are distributed round
+	 * 		  robin over the sensors which are not excluded, a probe of an excluded sensor takes one of them.
+	 */
+	void setSlots(uint8_t slots);
+
+	/**
+	 * @brief Runs one cycle of reads, see setSlots(). The sensors do not recover the bus themselves. After a timeout or
+	 * 		  TLI493D_MAX_BUS_ERRORS failed transfers of a sensor the array clears the bus and, if begin() was allowed to
+	 * 		  reset, resets it with the general call and writes the configuration of the last writeConfig() to every
+	 * 		  sensor on that bus; setter changes which were not written yet stay pending.
+	 * 		  Without reset only the failing sensor is configured again.
+	 * @return the number of successful reads
+	 */
+	uint8_t updateData(void);
+
+	/**
+	 * @return true if the sensor is excluded from the cycle by its health score
+	 */
+	bool isExcluded(uint8_t index);
+
+	/**
+	 * @return the duration of the last begin() in us
+	 */
+	uint32_t getBeginTime(void);
+
+	uint8_t getCount(void);
+	Tli493d &operator[](uint8_t index);
+
+  private:
+	Tli493d *const *mSensors;
+	uint8_t mCount;
+	uint8_t mImage[TLI493D_NUM_REG];
+	Tli493d::AccessMode_e mMode;
+	Tli493d::Range_e mRange;
+	uint8_t mCommitted[TLI493D_NUM_REG];	//image of the last writeConfig(), restored by a bus recovery
+	Tli493d::AccessMode_e mCommittedMode;
+	Tli493d::Range_e mCommittedRange;
+	uint32_t mBeginTime;
+	bool mReset;		//the general call may be used on the buses
+	tli493d::Health_t *mHealth;
+	Tli493d_HealthCallback_t mCallback;
+	uint8_t mSlots;
+	uint8_t mNext;		//next sensor of the round robin
+	uint8_t mProbe;		//next excluded sensor to probe
+	uint8_t mLast;		//sensor of the last read, consecutive reads of one sensor may see the same frame
+	uint8_t mCycle;
+
+	void setImageBits(uint8_t regMaskIndex, uint8_t data);
+
+	/**
+	 * @brief Copies the committed image into the local register copy of the sensor and writes it in two bursts
+	 */
+	bool writeSensor(Tli493d *sensor);
+
+	/**
+	 * @brief Computes the parity bits CP and FP of the image for IICadr = 0 and takes it as the configuration of the sensors
+	 */
+	void commitImage(void);
+
+	/**
+	 * @brief Reads one sensor and rates the read if the health scoring is enabled
+	 * @return true if the read was successful
+	 */
+	bool readSensor(uint8_t index);
+
+	/**
+	 * @brief Recovers the bus of a sensor, see updateData(); counted in the recovery statistics of that sensor
+	 */
+	void recoverBus(uint8_t index);
+
+	/**
+	 * @return the next sensor from start on which is (not) excluded, mCount if there is none
+	 */
+	uint8_t findSensor(uint8_t start, bool excluded);
+};
+
+#endif /* TLI493D_ARRAY_H_INCLUDED */
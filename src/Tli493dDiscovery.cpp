@@ -0,0 +1,122 @@
+/** @file Tli493dDiscovery.cpp
+ *  @brief Finds the TLI493D sensors on a bus and their silicon versions
+ */
+
+#include "Tli493dDiscovery.h"
+
+static const Tli493d::TypeAddress_e types[TLI493D_NUM_TYPES] = {Tli493d::TLI493D_A0, Tli493d::TLI493D_A1,
+																Tli493d::TLI493D_A2, Tli493d::TLI493D_A3};
+
+//C9h, D9h or E9h
+static bool knownVersion(uint8_t version)
+{
+	uint8_t high = version >> 4;
+	return (version & TLI493D_VERSION_MASK) == TLI493D_VERSION_LOW && high >= 0xC && high <= 0xE;
+}
+
+Tli493dDiscovery::Tli493dDiscovery(Tli493d::AccessMode_e mode) : mCandidates{Tli493d(mode, types[0]), Tli493d(mode, types[1]), Tli493d(mode, types[2]), Tli493d(mode, types[3])}, mCount(0), mTransactions(0)
+{
+	for (uint8_t i = 0; i < TLI493D_NUM_TYPES; i++)
+	{
+		mFound[i] = NULL;
+		mVersions[i] = 0;
+		mConflicts[i] = TLI493D_CONFLICT_NONE;
+	}
+}
+
+uint8_t Tli493dDiscovery::discover(TwoWire &bus, bool reset)
+{
+	mCount = 0;
+	mTransactions = 0;
+	bus.begin();
+	if (reset)
+	{
+		//the general call resets all sensors on the bus
+		mCandidates[0].initSensor(bus, types[0]);
+		mCandidates[0].resetSensor();
+	}
+
+	for (uint8_t i = 0; i < TLI493D_NUM_TYPES; i++)
+	{
+		uint8_t version = 0;
+		mConflicts[i] = TLI493D_CONFLICT_NONE;
+		if (!probe(bus, i, false, version))
+			continue;
+		//without reset the sensor may use the 1-byte read protocol and return register 00h
+		if (!knownVersion(version) && !reset && !probe(bus, i, true, version))
+			continue;
+		if (!knownVersion(version))
+		{
+			mConflicts[i] |= TLI493D_CONFLICT_FOREIGN;
+			continue;
+		}
+		mCandidates[i].initSensor(bus, types[i]);
+		mVersions[mCount] = version;
+		mFound[mCount++] = &mCandidates[i];
+	}
+	return mCount;
+}
+
+bool Tli493dDiscovery::probe(TwoWire &bus, uint8_t index, bool oneByteRead, uint8_t &version)
+{
+	uint8_t count = 1;
+	mTransactions++;
+	if (oneByteRead)
+	{
+		//the 1-byte read protocol always starts at register 00h
+		count = tli493d::VERSION_REGISTER + 1;
+	}
+	else
+	{
+		bus.beginTransmission(types[index]);
+		bus.write(tli493d::VERSION_REGISTER);
+		if (bus.endTransmission(false) != 0)
+			return false;
+	}
+
+	if (bus.requestFrom((uint8_t)types[index], count) != count)
+	{
+		mConflicts[index] |= TLI493D_CONFLICT_NO_READ;
+		return false;
+	}
+	for (uint8_t i = 0; i < count; i++)
+	{
+		version = bus.read();
+	}
+	return true;
+}
+
+uint8_t Tli493dDiscovery::getCount(void)
+{
+	return mCount;
+}
+
+Tli493d *const *Tli493dDiscovery::getSensors(void)
+{
+	return mFound;
+}
+
+Tli493d &Tli493dDiscovery::operator[](uint8_t index)
+{
+	return *mFound[index];
+}
+
+uint8_t Tli493dDiscovery::getVersion(uint8_t index)
+{
+	return index < mCount ? mVersions[index] : 0;
+}
+
+uint8_t Tli493dDiscovery::getConflicts(Tli493d::TypeAddress_e type)
+{
+	for (uint8_t i = 0; i < TLI493D_NUM_TYPES; i++)
+	{
+		if (types[i] == type)
+			return mConflicts[i];
+	}
+	return TLI493D_CONFLICT_NONE;
+}
+
+uint8_t Tli493dDiscovery::getTransactions(void)
+{
+	return mTransactions;
+}
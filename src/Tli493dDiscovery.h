@@ -0,0 +1,86 @@
+/** @file Tli493dDiscovery.h
+ *  @brief Finds the TLI493D sensors on a bus and their silicon versions
+ *
+ *	Each of the four addresses A0 to A3 is probed with one transaction: the address of the version register (16h) is
+ *	written and one byte is read after a repeated start. This needs the 2-byte read protocol (PR = 0), which is the
+ *	state after reset. Without reset, sensors which already use the 1-byte read protocol return register 00h instead;
+ *	only for those a full read-out of 23 bytes follows.
+ *	A device which answers with an unknown version is another device on the address of the sensor and is flagged as
+ *	conflict. Two sensors on the same address cannot be told apart by a read, since the bus combines their data.
+ */
+
+#ifndef TLI493D_DISCOVERY_H_INCLUDED
+#define TLI493D_DISCOVERY_H_INCLUDED
+
+#include "Tli493d.h"
+
+typedef enum Tli493d_Conflict
+{
+	TLI493D_CONFLICT_NONE = 0x00,
+	TLI493D_CONFLICT_FOREIGN = 0x01,	//a device answers with an unknown version, e.g. another device type
+	TLI493D_CONFLICT_NO_READ = 0x02		//the address is acknowledged, but the read fails
+} Tli493d_Conflict_t;
+
+class Tli493dDiscovery
+{
+  public:
+	/**
+	 * @brief Constructor; creates one sensor instance per address, the found ones are returned by getSensors()
+	 * @param mode Access mode of the sensor instances
+	 */
+	Tli493dDiscovery(Tli493d::AccessMode_e mode = Tli493d::MASTERCONTROLLEDMODE);
+
+	/**
+	 * @brief Probes the addresses A0 to A3. The sensors found are not started; pass getSensors() to Tli493dArray and
+	 * 		  call its begin() without reset, or call begin() of each sensor.
+	 * @param reset Resets all sensors on the bus with the general call first, which also returns them to their factory
+	 * 		  address and the 2-byte read protocol
+	 * @return the number of sensors found
+	 */
+	uint8_t discover(TwoWire &bus = Wire, bool reset = true);
+
+	/**
+	 * @return the number of sensors found by the last discover()
+	 */
+	uint8_t getCount(void);
+
+	/**
+	 * @return the sensors found, e.g. for Tli493dArray
+	 */
+	Tli493d *const *getSensors(void);
+
+	Tli493d &operator[](uint8_t index);
+
+	/**
+	 * @return the content of the version register (C9h, D9h or E9h) of the sensor with this index
+	 */
+	uint8_t getVersion(uint8_t index);
+
+	/**
+	 * @return the conflicts found on an address as combination of @ref Tli493d_Conflict
+	 */
+	uint8_t getConflicts(Tli493d::TypeAddress_e type);
+
+	/**
+	 * @return the number of bus transactions of the last discover(), without the reset
+	 */
+	uint8_t getTransactions(void);
+
+  private:
+	Tli493d mCandidates[TLI493D_NUM_TYPES];
+	Tli493d *mFound[TLI493D_NUM_TYPES];
+	uint8_t mVersions[TLI493D_NUM_TYPES];
+	uint8_t mConflicts[TLI493D_NUM_TYPES];
+	uint8_t mCount;
+	uint8_t mTransactions;
+
+	/**
+	 * @brief Reads the version register of one address
+	 * @param index Index of the address A0 to A3
+	 * @param oneByteRead Reads all registers up to the version register, for sensors in the 1-byte read protocol
+	 * @return true if a device answered and the read succeeded
+	 */
+	bool probe(TwoWire &bus, uint8_t index, bool oneByteRead, uint8_t &version);
+};
+
+#endif /* TLI493D_DISCOVERY_H_INCLUDED */
@@ -0,0 +1,133 @@
+/** @file Tli493dPair.cpp
+ *  @brief Gradiometric measurement with two TLI493D sensors on the same bus
+ */
+
+#include "Tli493dPair.h"
+#include <math.h>
+
+Tli493dPair::Tli493dPair(Tli493d &first, Tli493d &second) : mFirst(first), mSecond(second), mRatio(TLI493D_PAIR_RATIO), mStrayLimit(TLI493D_PAIR_STRAY_LIMIT), mSkew(0)
+{
+	for (uint8_t i = 0; i < 3; i++)
+	{
+		mField[i] = 0;
+		mStray[i] = 0;
+	}
+}
+
+bool Tli493dPair::setRatio(float ratio)
+{
+	if (!(ratio < TLI493D_PAIR_MAX_RATIO))
+		return false;
+	mRatio = ratio;
+	return true;
+}
+
+bool Tli493dPair::calibrate(uint16_t samples)
+{
+	float product = 0;
+	float square = 0;
+
+	for (uint16_t i = 0; i < samples; i++)
+	{
+		if (!mFirst.readField() || !mSecond.readField())
+			return false;
+		float b1[3] = {mFirst.getX(), mFirst.getY(), mFirst.getZ()};
+		float b2[3] = {mSecond.getX(), mSecond.getY(), mSecond.getZ()};
+		for (uint8_t j = 0; j < 3; j++)
+		{
+			product += b1[j] * b2[j];
+			square += b1[j] * b1[j];
+		}
+	}
+	//no magnet field at the first sensor
+	if (square <= 0)
+		return false;
+	return setRatio(product / square);
+}
+
+float Tli493dPair::getRatio(void)
+{
+	return mRatio;
+}
+
+void Tli493dPair::setStrayFieldLimit(float limit)
+{
+	mStrayLimit = limit;
+}
+
+Tli493d_Error Tli493dPair::updateData(void)
+{
+	uint32_t start = micros();
+	if (!mFirst.readField())
+		return TLI493D_BUS_ERROR;
+	uint32_t second = micros();
+	if (!mSecond.readField())
+		return TLI493D_BUS_ERROR;
+	mSkew = second - start;
+
+	//in mT, so both sensors may use different ranges
+	float b1[3] = {mFirst.getX(), mFirst.getY(), mFirst.getZ()};
+	float b2[3] = {mSecond.getX(), mSecond.getY(), mSecond.getZ()};
+	float scale = 1 / (1 - mRatio);
+	for (uint8_t i = 0; i < 3; i++)
+	{
+		mField[i] = (b1[i] - b2[i]) * scale;
+		mStray[i] = (b2[i] - mRatio * b1[i]) * scale;
+	}
+	return TLI493D_NO_ERROR;
+}
+
+float Tli493dPair::getX(void)
+{
+	return mField[0];
+}
+
+float Tli493dPair::getY(void)
+{
+	return mField[1];
+}
+
+float Tli493dPair::getZ(void)
+{
+	return mField[2];
+}
+
+float Tli493dPair::getNorm(void)
+{
+	return sqrt(mField[0] * mField[0] + mField[1] * mField[1] + mField[2] * mField[2]);
+}
+
+float Tli493dPair::getAzimuth(void)
+{
+	return atan2(mField[1], mField[0]);
+}
+
+float Tli493dPair::getStrayX(void)
+{
+	return mStray[0];
+}
+
+float Tli493dPair::getStrayY(void)
+{
+	return mStray[1];
+}
+
+float Tli493dPair::getStrayZ(void)
+{
+	return mStray[2];
+}
+
+float Tli493dPair::getStrayNorm(void)
+{
+	return sqrt(mStray[0] * mStray[0] + mStray[1] * mStray[1] + mStray[2] * mStray[2]);
+}
+
+bool Tli493dPair::strayFieldExceeded(void)
+{
+	return getStrayNorm() > mStrayLimit;
+}
+
+uint32_t Tli493dPair::getSkew(void)
+{
+	return mSkew;
+}
@@ -0,0 +1,122 @@
+/** @file Tli493dPair.h
+ *  @brief Gradiometric measurement with two TLI493D sensors on the same bus
+ *
+ *	A homogeneous stray field, e.g. from motor currents, adds the same vector s to both sensors, while the field of the
+ *	magnet differs between the two positions. With B1 = m + s and B2 = q * m + s the difference B1 - B2 = (1 - q) * m
+ *	is free of the stray field, and s = (B2 - q * B1) / (1 - q) can be bounded. The ratio q is -1 if the sensors see
+ *	opposite fields of the same size, and between 0 and 1 if the second sensor is further away from the magnet, e.g.
+ *	stacked along the rotation axis. It can be measured with calibrate().
+ *	Differences in sensitivity between the two sensors leave a small part of the stray field in the result.
+ */
+
+#ifndef TLI493D_PAIR_H_INCLUDED
+#define TLI493D_PAIR_H_INCLUDED
+
+#include "Tli493d.h"
+
+class Tli493dPair
+{
+  public:
+	/**
+	 * @brief Constructor of the pair. Both sensors must be started with begin() and use different addresses (TLI493D_A0 to
+	 * 		  TLI493D_A3) on the same bus. MASTERCONTROLLEDMODE triggers each measurement by the read-out, so the
+	 * 		  measurements of both sensors are apart by one read-out (about 200us at 400kHz, see getSkew()).
+	 * @param first Sensor next to the magnet
+	 * @param second Sensor further away or on the opposite side
+	 */
+	Tli493dPair(Tli493d &first, Tli493d &second);
+
+	/**
+	 * @brief Sets the ratio of the magnet field at the second sensor to the field at the first sensor
+	 * @param ratio Default TLI493D_PAIR_RATIO, must be smaller than TLI493D_PAIR_MAX_RATIO
+	 * @return false if the ratio is invalid, without taking effect
+	 */
+	bool setRatio(float ratio);
+
+	/**
+	 * @brief Measures the ratio of the magnet fields without stray field. The magnet may move during calibration;
+	 * 		  the ratio is the least squares fit of B2 = ratio * B1 over all samples.
+	 * @param samples Number of measurements, default TLI493D_PAIR_CAL_SAMPLES
+	 * @return false on bus error or if the ratio is not below TLI493D_PAIR_MAX_RATIO, without taking effect
+	 */
+	bool calibrate(uint16_t samples = TLI493D_PAIR_CAL_SAMPLES);
+
+	/**
+	 * @return the ratio of the magnet fields second/first sensor
+	 */
+	float getRatio(void);
+
+	/**
+	 * @brief Sets the bound of the stray field, above which strayFieldExceeded() returns true
+	 * @param limit Norm of the stray field in mT, default TLI493D_PAIR_STRAY_LIMIT
+	 */
+	void setStrayFieldLimit(float limit);
+
+	/**
+	 * @brief Reads Bx, By and Bz of both sensors directly after each other and calculates the differential field
+	 * 		  and the stray field. Temperature and diagnosis are not read. The values are kept on bus error.
+	 */
+	Tli493d_Error updateData(void);
+
+	/**
+	 * @return the x-component of the magnet field at the first sensor without stray field in mT
+	 */
+	float getX(void);
+	/**
+	 * @return the y-component of the magnet field at the first sensor without stray field in mT
+	 */
+	float getY(void);
+	/**
+	 * @return the z-component of the magnet field at the first sensor without stray field in mT
+	 */
+	float getZ(void);
+
+	/**
+	 * @return norm of the magnet field at the first sensor without stray field in mT
+	 */
+	float getNorm(void);
+
+	/**
+	 * @return the azimuth angle arctan(y/x) of the magnet field without stray field
+	 */
+	float getAzimuth(void);
+
+	/**
+	 * @return the x-component of the stray field in mT
+	 */
+	float getStrayX(void);
+	/**
+	 * @return the y-component of the stray field in mT
+	 */
+	float getStrayY(void);
+	/**
+	 * @return the z-component of the stray field in mT
+	 */
+	float getStrayZ(void);
+
+	/**
+	 * @return norm of the stray field in mT
+	 */
+	float getStrayNorm(void);
+
+	/**
+	 * @return true if the stray field of the last updateData() exceeds the limit set by setStrayFieldLimit()
+	 */
+	bool strayFieldExceeded(void);
+
+	/**
+	 * @return the time between the read-outs of both sensors in the last updateData() in us
+	 */
+	uint32_t getSkew(void);
+
+  private:
+	Tli493d &mFirst;
+	Tli493d &mSecond;
+	float mRatio;
+	float mStrayLimit;
+	float mField[3];
+	float mStray[3];
+	uint32_t mSkew;
+};
+
+#endif /* TLI493D_PAIR_H_INCLUDED */
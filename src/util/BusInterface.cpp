@@ -4,6 +4,15 @@ void tli493d::initInterface(BusInterface_t *interface, TwoWire *bus, uint8_t adr
 {
 	interface->bus = bus;
 	interface->adress = adress;
+	interface->errorCount = 0;
+	interface->busErrors = 0;
+	interface->recoveryCount = 0;
+	interface->recoveryTime = 0;
+	interface->readTimeout = 0;
+	interface->writeTimeout = 0;
+	interface->timeouts = 0;
+	interface->timedOut = false;
+	interface->lock = NULL;
 
 	// this sensor use different values to initialize registers :/
 	for (uint8_t i = 0; i < TLI493D_NUM_REG; i++)
@@ -12,6 +21,42 @@ void tli493d::initInterface(BusInterface_t *interface, TwoWire *bus, uint8_t adr
 	}
 }
 
+// the cores with WIRE_HAS_TIMEOUT abort a hanging transfer themselves, the others can only be checked afterwards
+void tli493d::setTimeouts(BusInterface_t *interface, uint16_t readTimeout, uint16_t writeTimeout)
+{
+	interface->readTimeout = readTimeout;
+	interface->writeTimeout = writeTimeout;
+#ifdef WIRE_HAS_TIMEOUT
+	uint16_t limit = max(readTimeout, writeTimeout);
+	if (limit != 0)
+		interface->bus->setWireTimeout(limit, true);
+	else
+		interface->bus->setWireTimeout(0, false);
+#endif
+}
+
+static bool expired(uint32_t start, uint16_t budget)
+{
+	return budget != 0 && micros() - start > budget;
+}
+
+// a transfer which missed its deadline fails, even if it returned data late
+static bool checkTimeout(tli493d::BusInterface_t *interface, uint32_t start, uint16_t budget)
+{
+	bool timeout = expired(start, budget);
+#ifdef WIRE_HAS_TIMEOUT
+	if (interface->bus->getWireTimeoutFlag())
+	{
+		interface->bus->clearWireTimeoutFlag();
+		timeout = true;
+	}
+#endif
+	interface->timedOut = timeout;
+	if (timeout && interface->timeouts < 0xFFFF)
+		interface->timeouts++;
+	return timeout;
+}
+
 bool tli493d::readOut(BusInterface_t *interface)
 {
 	return readOut(interface, TLI493D_NUM_REG);
@@ -25,33 +70,78 @@ bool tli493d::readOut(BusInterface_t *interface, uint8_t count)
 	{
 		count = TLI493D_NUM_REG;
 	}
+	LockGuard guard(interface->lock);
+	uint32_t start = micros();
 	uint8_t received_bytes = interface->bus->requestFrom(interface->adress, count);
 	if (received_bytes == count)
 	{
+		ret = BUS_OK;
 		for (i = 0; i < count; i++)
 		{
+			//read() returns -1 instead of waiting, so wait for the data with the deadline
+			while (interface->bus->available() <= 0 && !expired(start, interface->readTimeout))
+				;
+			if (interface->bus->available() <= 0)
+			{
+				ret = BUS_ERROR;
+				break;
+			}
 			if(i < 0x14 || i > 0x15)	//Skip the "write-only" registers
 				interface->regData[i] = interface->bus->read();
 			else
 				interface->bus->read();
 		}
-		ret = BUS_OK;
 	}
+	if (checkTimeout(interface, start, interface->readTimeout))
+		ret = BUS_ERROR;
+	countResult(interface, ret);
 	return ret;
 }
 
 // write out to a specific register
 bool tli493d::writeOut(BusInterface_t *interface, uint8_t regAddr)
+{
+	return writeOut(interface, regAddr, 1);
+}
+
+// write out count consecutive registers in one transfer, the sensor increments the address
+bool tli493d::writeOut(BusInterface_t *interface, uint8_t regAddr, uint8_t count)
 {
 	bool ret = BUS_ERROR;
+	if (regAddr + count > TLI493D_NUM_REG)
+	{
+		count = TLI493D_NUM_REG - regAddr;
+	}
+	LockGuard guard(interface->lock);
+	uint32_t start = micros();
 	interface->bus->beginTransmission(interface->adress);
 
 	interface->bus->write(regAddr);
-	interface->bus->write(interface->regData[regAddr]);
+	for (uint8_t i = 0; i < count; i++)
+	{
+		interface->bus->write(interface->regData[regAddr + i]);
+	}
 
 	if (interface->bus->endTransmission() == 0)
 	{
 		ret = BUS_OK;
 	}
+	if (checkTimeout(interface, start, interface->writeTimeout))
+		ret = BUS_ERROR;
+	countResult(interface, ret);
 	return ret;
-}
\ No newline at end of file
+}
+
+void tli493d::countResult(BusInterface_t *interface, bool result)
+{
+	if (result == BUS_OK)
+	{
+		interface->errorCount = 0;
+		return;
+	}
+	//saturate instead of wrapping, so that a stuck bus stays visible
+	if (interface->errorCount < 0xFF)
+		interface->errorCount++;
+	if (interface->busErrors < 0xFFFF)
+		interface->busErrors++;
+}
@@ -3,6 +3,7 @@
 
 #include <Arduino.h>
 #include <Wire.h>
+#include "Lock.h"
 
 #define TLI493D_NUM_REG		23
 
@@ -14,6 +15,15 @@ typedef struct
 	TwoWire *bus;
 	uint8_t adress;
 	uint8_t regData[TLI493D_NUM_REG];
+	uint8_t errorCount;			//consecutive failed transfers, reset by the next successful one
+	uint16_t busErrors;			//total failed transfers (NACK or short read)
+	uint16_t recoveryCount;		//number of bus recoveries carried out
+	uint32_t recoveryTime;		//duration of the longest recovery in us
+	uint16_t readTimeout;		//budget of a read transfer in us, 0 disables the deadline
+	uint16_t writeTimeout;		//budget of a write transfer in us, 0 disables the deadline
+	uint16_t timeouts;			//total transfers which missed their deadline
+	bool timedOut;				//the last transfer missed its deadline
+	const Lock_t *lock;			//held during each transfer, NULL without locking
 } BusInterface_t;
 
 }
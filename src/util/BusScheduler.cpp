@@ -0,0 +1,142 @@
+#include "BusScheduler.h"
+
+using tli493d::BusJob_t;
+using tli493d::BusScheduler_t;
+
+static int32_t timeDiff(uint32_t a, uint32_t b)
+{
+	return (int32_t)(a - b);
+}
+
+//a chunk of the job may start if it ends before the next release of any periodic job with higher priority
+static bool fitsSlots(const BusScheduler_t *scheduler, const BusJob_t *job, uint32_t now)
+{
+	for (uint8_t i = 0; i < scheduler->count; i++)
+	{
+		const BusJob_t *other = scheduler->jobs[i];
+		if (other == job || other->period == 0 || other->priority <= job->priority)
+			continue;
+		//a release in the past is already ready and has been preferred
+		if (timeDiff(other->release, now) > 0 && timeDiff(other->release, now + job->chunkTime) < 0)
+			return false;
+	}
+	return true;
+}
+
+//true if a should run before b
+static bool precedes(const BusJob_t *a, const BusJob_t *b)
+{
+	if (a->priority != b->priority)
+		return a->priority > b->priority;
+	return timeDiff(a->release + a->deadline, b->release + b->deadline) < 0;
+}
+
+void tli493d::initBusScheduler(BusScheduler_t *scheduler)
+{
+	scheduler->count = 0;
+}
+
+void tli493d::initBusJob(BusJob_t *job, BusJobStep_t step, void *context, uint8_t priority, uint32_t period,
+						 uint32_t deadline, uint32_t chunkTime, uint32_t firstRelease)
+{
+	job->step = step;
+	job->context = context;
+	job->priority = priority;
+	job->period = period;
+	job->deadline = deadline;
+	job->chunkTime = chunkTime;
+	job->release = firstRelease;
+	job->chunk = 0;
+	job->active = period != 0;
+	job->maxBlocking = 0;
+	job->maxChunk = 0;
+	job->misses = 0;
+}
+
+bool tli493d::addBusJob(BusScheduler_t *scheduler, BusJob_t *job)
+{
+	if (scheduler->count >= TLI493D_BUS_MAX_JOBS)
+		return false;
+	scheduler->jobs[scheduler->count++] = job;
+	return true;
+}
+
+bool tli493d::submitBusJob(BusJob_t *job, uint32_t now)
+{
+	if (job->active)
+		return false;
+	job->release = now;
+	job->chunk = 0;
+	job->active = true;
+	return true;
+}
+
+bool tli493d::runBusScheduler(BusScheduler_t *scheduler, uint32_t now)
+{
+	BusJob_t *next = NULL;
+	for (uint8_t i = 0; i < scheduler->count; i++)
+	{
+		BusJob_t *job = scheduler->jobs[i];
+		if (!job->active || timeDiff(now, job->release) < 0 || !fitsSlots(scheduler, job, now))
+			continue;
+		if (next == NULL || precedes(job, next))
+			next = job;
+	}
+	if (next == NULL)
+		return false;
+
+	if (next->chunk == 0)
+	{
+		uint32_t blocking = now - next->release;
+		if (blocking > next->maxBlocking)
+			next->maxBlocking = blocking;
+	}
+
+	uint32_t start = micros();
+	bool finished = next->step(next->context, next->chunk);
+	uint32_t end = micros();
+	if (end - start > next->maxChunk)
+		next->maxChunk = end - start;
+
+	if (!finished)
+	{
+		next->chunk++;
+		return true;
+	}
+
+	if (timeDiff(end, next->release + next->deadline) > 0 && next->misses < 0xFFFF)
+		next->misses++;
+	next->chunk = 0;
+	if (next->period == 0)
+	{
+		next->active = false;
+	}
+	else
+	{
+		//skip releases that have passed completely, they count as misses
+		next->release += next->period;
+		while (timeDiff(end, next->release + next->deadline) > 0)
+		{
+			next->release += next->period;
+			if (next->misses < 0xFFFF)
+				next->misses++;
+		}
+	}
+	return true;
+}
+
+uint32_t tli493d::getBusBlockingBound(const BusScheduler_t *scheduler, const BusJob_t *job)
+{
+	uint32_t bound = 0;
+	for (uint8_t i = 0; i < scheduler->count; i++)
+	{
+		const BusJob_t *other = scheduler->jobs[i];
+		if (other != job && other->priority <= job->priority)
+		{
+			uint32_t chunk = max(other->chunkTime, other->maxChunk);
+			if (chunk > bound)
+				bound = chunk;
+		}
+	}
+	return bound;
+}
@@ -0,0 +1,87 @@
+#ifndef TLI493D_BUS_SCHEDULER_H_INCLUDED
+#define TLI493D_BUS_SCHEDULER_H_INCLUDED
+
+#include <Arduino.h>
+
+#define TLI493D_BUS_MAX_JOBS		8
+
+namespace tli493d
+{
+
+/**
+ * @brief Runs one chunk of a job, e.g. one I2C transfer
+ * @param context Pointer given to initBusJob(), e.g. the device object
+ * @param chunk Number of the chunk, counting from 0 for each activation of the job
+ * @return true if the job is finished
+ */
+typedef bool (*BusJobStep_t)(void *context, uint8_t chunk);
+
+/**
+ * A client of the shared bus, e.g. the periodic read-out of a sensor or the page writes to an EEPROM
+ */
+typedef struct
+{
+	BusJobStep_t step;
+	void *context;
+	uint8_t priority;		//higher runs first
+	uint32_t period;		//in us, 0 for a job that runs once per submitBusJob()
+	uint32_t deadline;		//relative to the release in us
+	uint32_t chunkTime;		//longest duration of one chunk in us, for the protection of the periodic slots
+	uint32_t release;		//time from which the job is ready in us
+	uint8_t chunk;			//next chunk
+	bool active;
+	uint32_t maxBlocking;	//longest time from the release to the start of the first chunk in us
+	uint32_t maxChunk;		//longest measured chunk in us
+	uint16_t misses;		//activations finished after the deadline
+} BusJob_t;
+
+/**
+ * Non-preemptive scheduler of bus transfers. Jobs are split into chunks, and only one chunk runs per call of
+ * runBusScheduler(), so other clients wait at most one chunk. Among the ready jobs the highest priority runs first,
+ * equal priorities by earliest deadline. A chunk only starts if its chunkTime ends before the next release of a
+ * periodic job of higher priority, which guarantees the periodic slots, e.g. of the sensor read-out.
+ */
+typedef struct
+{
+	BusJob_t *jobs[TLI493D_BUS_MAX_JOBS];
+	uint8_t count;
+} BusScheduler_t;
+
+void initBusScheduler(BusScheduler_t *scheduler);
+
+/**
+ * @param period Period in us, 0 for a job started with submitBusJob()
+ * @param deadline Deadline relative to the release in us
+ * @param chunkTime Longest duration of a chunk in us, e.g. 300 for a 7 byte read at 400kHz
+ * @param firstRelease Time of the first release of a periodic job in us
+ */
+void initBusJob(BusJob_t *job, BusJobStep_t step, void *context, uint8_t priority, uint32_t period, uint32_t deadline,
+				uint32_t chunkTime, uint32_t firstRelease);
+
+/**
+ * @return false if the scheduler is full
+ */
+bool addBusJob(BusScheduler_t *scheduler, BusJob_t *job);
+
+/**
+ * @brief Releases a one-shot job, e.g. a configuration change or an EEPROM write
+ * @return false if the job is still running
+ */
+bool submitBusJob(BusJob_t *job, uint32_t now);
+
+/**
+ * @brief Runs at most one chunk; call it from the main loop as often as possible
+ * @param now Current time in us, e.g. micros()
+ * @return true if a chunk was run
+ */
+bool runBusScheduler(BusScheduler_t *scheduler, uint32_t now);
+
+/**
+ * @brief Worst-case blocking of a job in us by chunks of jobs with lower priority, which cannot be interrupted.
+ * 		  Compare with BusJob_t::maxBlocking, which also contains the time spent in higher priority jobs.
+ */
+uint32_t getBusBlockingBound(const BusScheduler_t *scheduler, const BusJob_t *job);
+
+}
+
+#endif
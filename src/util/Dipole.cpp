@@ -0,0 +1,122 @@
+#include "Dipole.h"
+#include <math.h>
+
+#if TLI493D_DIPOLE_FAST
+//position angle theta over the field angle beta = theta + atan(tan(theta) / 2) in 16 steps of pi/16 from 0 to pi:
+//cos(theta), sin(theta) and cbrt(sqrt(1 + 3 cos^2(theta)))
+static const float dipoleTable[17][3] = {
+	{1.00000f, 0.00000f, 1.25992f},
+	{0.99147f, 0.13034f, 1.25723f},
+	{0.96631f, 0.25737f, 1.24927f},
+	{0.92580f, 0.37802f, 1.23634f},
+	{0.87193f, 0.48963f, 1.21898f},
+	{0.80727f, 0.59019f, 1.19792f},
+	{0.73470f, 0.67839f, 1.17408f},
+	{0.65716f, 0.75375f, 1.14855f},
+	{0.57735f, 0.81650f, 1.12246f},
+	{0.49749f, 0.86747f, 1.09697f},
+	{0.41916f, 0.90791f, 1.07311f},
+	{0.34333f, 0.93922f, 1.05176f},
+	{0.27032f, 0.96277f, 1.03359f},
+	{0.20003f, 0.97979f, 1.01907f},
+	{0.13201f, 0.99125f, 1.00853f},
+	{0.06559f, 0.99785f, 1.00214f},
+	{0.00000f, 1.00000f, 1.00000f},
+};
+
+//atan2 for y >= 0 with an error below 0.004 rad
+static float fastAtan2(float y, float x)
+{
+	float ax = fabs(x);
+	if (ax < 1e-20f && y < 1e-20f)
+		return 0;
+	float z = ax > y ? y / ax : ax / y;
+	float a = z * (0.7853982f + 0.273f * (1 - z));
+	if (y > ax)
+		a = 1.5707963f - a;
+	return x < 0 ? 3.1415927f - a : a;
+}
+
+//inverse cube root: exponent trick as first guess and Newton iterations
+static float fastInvCbrt(float x)
+{
+	union
+	{
+		float f;
+		uint32_t i;
+	} u;
+	u.f = x;
+	u.i = 0x54A2FA8CUL - u.i / 3;
+	float y = u.f;
+	for (uint8_t i = 0; i < TLI493D_DIPOLE_NEWTON; i++)
+		y = y * (4.0f - x * y * y * y) * (1.0f / 3.0f);
+	return y;
+}
+#endif
+
+void tli493d::calibrateDipole(Dipole_t *dipole, float bx, float by, float bz, float distance, float noise, float range)
+{
+	//on the axis: B = 2 C / r^3
+	float norm = sqrt(bx * bx + by * by + bz * bz);
+	dipole->moment = norm * distance * distance * distance / 2;
+	dipole->cbrtMoment = cbrt(dipole->moment);
+	dipole->noise = noise;
+	dipole->range = range;
+}
+
+void tli493d::estimateDipole(const Dipole_t *dipole, float bx, float by, float bz, DipoleEstimate_t *estimate)
+{
+	float rho = sqrt(bx * bx + by * by);
+	float norm = sqrt(rho * rho + bz * bz);
+	float cosTheta, sinTheta, cbrtG;
+
+	if (norm <= 0 || dipole->moment <= 0)
+	{
+		estimate->distance = 0;
+		estimate->direction[0] = estimate->direction[1] = 0;
+		estimate->direction[2] = 1;
+		estimate->confidence = 0;
+		return;
+	}
+
+#if TLI493D_DIPOLE_FAST
+	float index = fastAtan2(rho, bz) * (16 / 3.1415927f);
+	uint8_t i = (uint8_t)index;
+	if (i > 15)
+		i = 15;
+	float frac = index - i;
+	cosTheta = dipoleTable[i][0] + (dipoleTable[i + 1][0] - dipoleTable[i][0]) * frac;
+	sinTheta = dipoleTable[i][1] + (dipoleTable[i + 1][1] - dipoleTable[i][1]) * frac;
+	cbrtG = dipoleTable[i][2] + (dipoleTable[i + 1][2] - dipoleTable[i][2]) * frac;
+	//r = cbrt(C * g / |B|)
+	estimate->distance = dipole->cbrtMoment * cbrtG * fastInvCbrt(norm);
+#else
+	//solve beta = theta + atan(tan(theta) / 2) by Newton iterations
+	float beta = atan2(rho, bz);
+	float theta = beta / 2;
+	for (uint8_t i = 0; i < 8; i++)
+	{
+		float t = tan(theta);
+		float f = theta + atan(t / 2) - beta;
+		float df = 1 + (1 + t * t) / 2 / (1 + t * t / 4);
+		theta = constrain(theta - f / df, 0.0f, 1.5707963f);
+	}
+	cosTheta = cos(theta);
+	sinTheta = sin(theta);
+	cbrtG = cbrt(sqrt(1 + 3 * cosTheta * cosTheta));
+	estimate->distance = cbrt(dipole->moment / norm) * cbrtG;
+#endif
+
+	//azimuth of the position is the azimuth of the field
+	estimate->direction[0] = rho > 0 ? sinTheta * bx / rho : 0;
+	estimate->direction[1] = rho > 0 ? sinTheta * by / rho : 0;
+	estimate->direction[2] = cosTheta;
+
+	//confidence from the signal to noise ratio, none if the field is clipped
+	float snr = dipole->noise > 0 ? norm / dipole->noise : TLI493D_DIPOLE_FULL_SNR;
+	float confidence = (snr - TLI493D_DIPOLE_MIN_SNR) / (TLI493D_DIPOLE_FULL_SNR - TLI493D_DIPOLE_MIN_SNR);
+	float limit = TLI493D_DIPOLE_SATURATION * dipole->range;
+	if (fabs(bx) > limit || fabs(by) > limit || fabs(bz) > limit)
+		confidence = 0;
+	estimate->confidence = (uint8_t)(constrain(confidence, 0.0f, 1.0f) * 255);
+}
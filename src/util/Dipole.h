@@ -0,0 +1,57 @@
+#ifndef TLI493D_DIPOLE_H_INCLUDED
+#define TLI493D_DIPOLE_H_INCLUDED
+
+#include <Arduino.h>
+
+//1: lookup table, approximated atan2 and inverse cube root with TLI493D_DIPOLE_NEWTON iterations; 0: exact math library
+#ifndef TLI493D_DIPOLE_FAST
+#define TLI493D_DIPOLE_FAST			1
+#endif
+#ifndef TLI493D_DIPOLE_NEWTON
+#define TLI493D_DIPOLE_NEWTON		1	//iterations: 0.3% distance error with one, 0.002% with two, 3 are exact in float
+#endif
+
+#define TLI493D_DIPOLE_MIN_SNR		3.0		//no confidence below this signal to noise ratio
+#define TLI493D_DIPOLE_FULL_SNR		50.0	//full confidence above this signal to noise ratio
+#define TLI493D_DIPOLE_SATURATION	0.95	//no confidence if a component exceeds this fraction of the range
+
+namespace tli493d
+{
+
+/**
+ * Calibration of a magnet, which is magnetised along the z axis of the sensor
+ */
+typedef struct
+{
+	float moment;		//dipole constant C in B = C / r^3 * sqrt(1 + 3 cos^2(theta)), e.g. in mT*mm^3
+	float cbrtMoment;	//cube root of the dipole constant
+	float noise;		//noise of the field in mT
+	float range;		//largest field the sensor can measure in the current range in mT
+} Dipole_t;
+
+typedef struct
+{
+	float distance;			//distance between magnet and sensor in the unit of the calibration
+	float direction[3];		//unit vector from the magnet to the sensor
+	uint8_t confidence;		//0 (unusable) to 255
+} DipoleEstimate_t;
+
+/**
+ * @brief Calibrates the dipole constant with the sensor on the magnet axis at a known distance
+ * @param bx, by, bz Field in mT
+ * @param distance Distance between magnet centre and sensor, e.g. in mm
+ * @param noise Noise of the field in mT, e.g. from the statistics
+ * @param range Largest measurable field in mT, e.g. 160 for FULL range
+ */
+void calibrateDipole(Dipole_t *dipole, float bx, float by, float bz, float distance, float noise, float range);
+
+/**
+ * @brief Estimates distance and direction of the magnet from the field vector with the dipole model. A dipole field is
+ * 		  symmetric to the magnet centre, so the sensor is assumed on the side of the north pole (positive z).
+ * @param bx, by, bz Field in mT
+ */
+void estimateDipole(const Dipole_t *dipole, float bx, float by, float bz, DipoleEstimate_t *estimate);
+
+}
+
+#endif
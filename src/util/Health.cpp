@@ -0,0 +1,45 @@
+#include "Health.h"
+
+void tli493d::initHealth(Health_t *health)
+{
+	health->score = TLI493D_HEALTH_MAX;
+	health->excluded = false;
+	health->frame = TLI493D_HEALTH_NO_FRAME;
+	health->faults = 0;
+	health->exclusions = 0;
+}
+
+uint8_t tli493d::addToHealth(Health_t *health, uint8_t faults)
+{
+	int16_t score = health->score;
+
+	if (faults == HEALTH_OK)
+	{
+		score += (TLI493D_HEALTH_MAX - score) >> TLI493D_HEALTH_RISE;
+	}
+	else
+	{
+		if (health->faults < 0xFFFF)
+			health->faults++;
+		if (faults & (HEALTH_BUS | HEALTH_PARITY))
+			score -= (score >> 2) + TLI493D_HEALTH_PENALTY;
+		//a stale frame may also be a read faster than the update rate, it cannot exclude the sensor alone
+		if ((faults & HEALTH_STALE) && score > TLI493D_HEALTH_STALE_FLOOR)
+			score = max((int16_t)(score - (score >> 3)), (int16_t)TLI493D_HEALTH_STALE_FLOOR);
+	}
+	health->score = max(score, (int16_t)0);
+
+	if (!health->excluded && health->score < TLI493D_HEALTH_EXCLUDE)
+	{
+		health->excluded = true;
+		if (health->exclusions < 0xFFFF)
+			health->exclusions++;
+		return HEALTH_EXCLUDED;
+	}
+	if (health->excluded && health->score >= TLI493D_HEALTH_READMIT)
+	{
+		health->excluded = false;
+		return HEALTH_READMITTED;
+	}
+	return HEALTH_NO_EVENT;
+}
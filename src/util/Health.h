@@ -0,0 +1,59 @@
+#ifndef TLI493D_HEALTH_H_INCLUDED
+#define TLI493D_HEALTH_H_INCLUDED
+
+#include <Arduino.h>
+
+#define TLI493D_HEALTH_MAX			255
+#define TLI493D_HEALTH_RISE			3	//a good read closes 1/8 of the gap to TLI493D_HEALTH_MAX
+#define TLI493D_HEALTH_PENALTY		16	//a bus or parity fault costs 1/4 of the score plus this value
+#define TLI493D_HEALTH_EXCLUDE		64	//below this score the sensor is excluded, after about 4 faults in a row
+#define TLI493D_HEALTH_READMIT		128	//an excluded sensor is taken back at this score, after about 5 good probes
+#define TLI493D_HEALTH_STALE_FLOOR	128	//stale frames alone do not lower the score below this value
+#define TLI493D_HEALTH_PROBE_CYCLES	16	//cycles between two probes of an excluded sensor
+#define TLI493D_HEALTH_NO_FRAME		0xFF
+
+namespace tli493d
+{
+
+enum HealthFault_e
+{
+	HEALTH_OK = 0x00,
+	HEALTH_BUS = 0x01,		//NACK, short read or timeout
+	HEALTH_STALE = 0x02,	//frame counter did not advance
+	HEALTH_PARITY = 0x04	//fuse or configuration parity flag not set
+};
+
+enum HealthEvent_e
+{
+	HEALTH_NO_EVENT = 0,
+	HEALTH_EXCLUDED = 1,
+	HEALTH_READMITTED = 2
+};
+
+/**
+ * Health score of a sensor from the results of its reads. Faults lower the score quickly, good reads raise it slowly,
+ * so a sensor failing every second read drops below TLI493D_HEALTH_EXCLUDE, while one failing every tenth read stays
+ * above 200. Exclusion and readmission have a hysteresis. Stale frames stop at TLI493D_HEALTH_STALE_FLOOR, since a
+ * sensor polled faster than its update rate repeats frames without being faulty.
+ */
+typedef struct
+{
+	uint8_t score;
+	bool excluded;
+	uint8_t frame;			//frame counter of the last read, TLI493D_HEALTH_NO_FRAME if unknown
+	uint16_t faults;		//reads with at least one fault
+	uint16_t exclusions;
+} Health_t;
+
+void initHealth(Health_t *health);
+
+/**
+ * @brief Rates one read
+ * @param faults Combination of @ref HealthFault_e
+ * @return @ref HealthEvent_e if the sensor was excluded or readmitted
+ */
+uint8_t addToHealth(Health_t *health, uint8_t faults);
+
+}
+
+#endif
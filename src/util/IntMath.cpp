@@ -0,0 +1,149 @@
+#include "IntMath.h"
+#include <math.h>
+
+//sin(k * pi / 128) in Q15 for k = 0..64
+static const int16_t quarterSine[65] TLI493D_PROGMEM = {
+	0, 804, 1608, 2411, 3212, 4011, 4808, 5602,
+	6393, 7180, 7962, 8740, 9512, 10279, 11039, 11793,
+	12540, 13279, 14010, 14733, 15447, 16151, 16846, 17531,
+	18205, 18868, 19520, 20160, 20788, 21403, 22006, 22595,
+	23170, 23732, 24279, 24812, 25330, 25833, 26320, 26791,
+	27246, 27684, 28106, 28511, 28899, 29269, 29622, 29957,
+	30274, 30572, 30853, 31114, 31357, 31581, 31786, 31972,
+	32138, 32286, 32413, 32522, 32610, 32679, 32729, 32758,
+	32767,
+};
+
+//atan(k / 32) for k = 0..32, full circle is 65536
+static const int16_t octantAtan[33] TLI493D_PROGMEM = {
+	0, 326, 651, 975, 1297, 1617, 1933, 2246,
+	2555, 2860, 3159, 3453, 3742, 4025, 4302, 4572,
+	4836, 5094, 5344, 5589, 5826, 6058, 6282, 6500,
+	6712, 6917, 7117, 7310, 7498, 7679, 7856, 8026,
+	8192,
+};
+
+uint16_t tli493d::sqrtInt(uint32_t value)
+{
+	//bitwise method, one result bit per iteration
+	uint32_t root = 0;
+	uint32_t bit = 1UL << 30;
+
+	while (bit > value)
+		bit >>= 2;
+	while (bit != 0)
+	{
+		if (value >= root + bit)
+		{
+			value -= root + bit;
+			root = (root >> 1) + bit;
+		}
+		else
+		{
+			root >>= 1;
+		}
+		bit >>= 2;
+	}
+	return (uint16_t)root;
+}
+
+uint16_t tli493d::pseudoAngle(int16_t y, int16_t x)
+{
+	int32_t ax = x < 0 ? -(int32_t)x : x;
+	int32_t ay = y < 0 ? -(int32_t)y : y;
+	if (ax + ay == 0)
+		return 0;
+
+	//position on the diamond |x| + |y| = 1 within the quadrant, 16384 per quadrant
+	uint16_t t = (uint16_t)((ay << 14) / (ax + ay));
+	if (y >= 0)
+		return x >= 0 ? t : 32768U - t;
+	return x < 0 ? 32768U + t : (uint16_t)(65536UL - t);
+}
+
+tli493d::Bam_t tli493d::atan2Int(int16_t y, int16_t x)
+{
+	uint32_t ax = x < 0 ? -(int32_t)x : x;
+	uint32_t ay = y < 0 ? -(int32_t)y : y;
+	if (ax == 0 && ay == 0)
+		return 0;
+
+	//ratio of the smaller to the larger component in Q16, within the first octant
+	bool swap = ay > ax;
+	uint32_t ratio = swap ? (ax << 16) / ay : (ay << 16) / ax;
+	uint8_t index = ratio >> 11;
+	uint16_t frac = ratio & 0x7FF;
+	if (index == 32)
+	{
+		index = 31;
+		frac = 0x800;
+	}
+	int16_t low = TLI493D_READ_WORD(&octantAtan[index]);
+	int16_t high = TLI493D_READ_WORD(&octantAtan[index + 1]);
+	Bam_t angle = low + (((int32_t)(high - low) * frac + 0x400) >> 11);
+
+	if (swap)
+		angle = TLI493D_BAM_QUARTER - angle;
+	if (x < 0)
+		angle = TLI493D_BAM_HALF - angle;
+	if (y < 0)
+		angle = -angle;
+	return angle;
+}
+
+int16_t tli493d::sinInt(uint8_t angle)
+{
+	uint8_t index = angle & 0x3F;
+	//second and fourth quadrant run backwards through the table
+	if (angle & 0x40)
+		index = 64 - index;
+	int16_t value = TLI493D_READ_WORD(&quarterSine[index]);
+	return (angle & 0x80) ? -value : value;
+}
+
+int16_t tli493d::cosInt(uint8_t angle)
+{
+	return sinInt(angle + 64);
+}
+
+int16_t tli493d::sinBam(Bam_t angle)
+{
+	uint16_t position = angle & (TLI493D_BAM_QUARTER - 1);
+	//second and fourth quadrant run backwards through the table
+	if (angle & TLI493D_BAM_QUARTER)
+		position = TLI493D_BAM_QUARTER - position;
+	uint8_t index = position >> 8;
+	int16_t value = TLI493D_READ_WORD(&quarterSine[index]);
+	if (index < 64)
+	{
+		int16_t next = TLI493D_READ_WORD(&quarterSine[index + 1]);
+		value += ((int32_t)(next - value) * (position & 0xFF) + 0x80) >> 8;
+	}
+	return (angle & TLI493D_BAM_HALF) ? -value : value;
+}
+
+int16_t tli493d::cosBam(Bam_t angle)
+{
+	return sinBam(angle + TLI493D_BAM_QUARTER);
+}
+
+float tli493d::bamToDegrees(Bam_t angle)
+{
+	return angle * (360.0f / 65536);
+}
+
+float tli493d::bamToRadians(Bam_t angle)
+{
+	return angle * (float)(2 * PI / 65536);
+}
+
+tli493d::Bam_t tli493d::degreesToBam(float degrees)
+{
+	//through int32_t, so negative angles wrap around
+	return (Bam_t)(int32_t)lround(degrees * (65536 / 360.0f));
+}
+
+tli493d::Bam_t tli493d::radiansToBam(float radians)
+{
+	return (Bam_t)(int32_t)lround(radians * (float)(65536 / (2 * PI)));
+}
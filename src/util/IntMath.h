@@ -0,0 +1,83 @@
+#ifndef TLI493D_INTMATH_H_INCLUDED
+#define TLI493D_INTMATH_H_INCLUDED
+
+#include <Arduino.h>
+
+//constant tables are kept in flash on AVR, other architectures map constants to flash anyway
+#if defined(__AVR__)
+#include <avr/pgmspace.h>
+#define TLI493D_PROGMEM				PROGMEM
+#define TLI493D_READ_WORD(addr)		((int16_t)pgm_read_word(addr))
+#else
+#define TLI493D_PROGMEM
+#define TLI493D_READ_WORD(addr)		(*(addr))
+#endif
+
+#define TLI493D_Q15_ONE				32767
+#define TLI493D_BAM_HALF			32768U	//binary angle of 180 degree
+#define TLI493D_BAM_QUARTER			16384U	//binary angle of 90 degree
+
+namespace tli493d
+{
+
+/**
+ * Binary angle: the full circle is 65536, so angles wrap around with the overflow of uint16_t. The difference of two
+ * angles cast to int16_t is the signed difference in [-180,180) degree.
+ */
+typedef uint16_t Bam_t;
+
+/**
+ * @brief Integer square root, rounded down
+ */
+uint16_t sqrtInt(uint32_t value);
+
+/**
+ * @brief Pseudo angle of the vector (x, y), monotonic in atan2(y, x) but cheaper: one division and no table.
+ * 		  It is exact on the axes and diagonals and deviates up to about 4 degree in between.
+ * @return the pseudo angle, full circle is 65536
+ */
+uint16_t pseudoAngle(int16_t y, int16_t x);
+
+/**
+ * @brief Integer atan2 from a table of 33 values with linear interpolation, one division
+ * @return the angle of the vector (x, y) with an error of about 0.01 degree, full circle is 65536
+ */
+Bam_t atan2Int(int16_t y, int16_t x);
+
+/**
+ * @brief Sine from a quarter wave table
+ * @param angle Full circle is 256, so the angle wraps around with the overflow of uint8_t
+ * @return sine in Q15
+ */
+int16_t sinInt(uint8_t angle);
+
+/**
+ * @brief Cosine from a quarter wave table
+ * @param angle Full circle is 256
+ * @return cosine in Q15
+ */
+int16_t cosInt(uint8_t angle);
+
+/**
+ * @brief Sine of a binary angle, interpolated linearly in the quarter wave table (error below 0.0001)
+ * @return sine in Q15
+ */
+int16_t sinBam(Bam_t angle);
+
+/**
+ * @brief Cosine of a binary angle
+ * @return cosine in Q15
+ */
+int16_t cosBam(Bam_t angle);
+
+/**
+ * @brief Conversions at the edges, e.g. for printing or configuration
+ */
+float bamToDegrees(Bam_t angle);
+float bamToRadians(Bam_t angle);
+Bam_t degreesToBam(float degrees);
+Bam_t radiansToBam(float radians);
+
+}
+
+#endif
@@ -0,0 +1,112 @@
+#include "Joystick.h"
+#include <math.h>
+
+//normalises a deflection to [-TLI493D_JOYSTICK_MAX,TLI493D_JOYSTICK_MAX] and linearises it with the table
+static int16_t mapAxis(const tli493d::Joystick_t *joystick, int16_t value, int16_t center, int16_t low, int16_t high,
+					   uint8_t scaleIndex)
+{
+	int32_t d = (int32_t)value - center;
+	bool negative = d < 0;
+	int32_t range = negative ? center - low : high - center;
+
+	if (negative)
+		d = -d;
+	if (d > range)
+		d = range;
+	uint32_t u = ((uint32_t)d * joystick->scale[scaleIndex + negative]) >> 16;
+	if (u > TLI493D_JOYSTICK_MAX)
+		u = TLI493D_JOYSTICK_MAX;
+
+	uint8_t i = u >> TLI493D_JOYSTICK_LUT_SHIFT;
+	if (i >= TLI493D_JOYSTICK_LUT_SIZE - 1)
+		i = TLI493D_JOYSTICK_LUT_SIZE - 2;
+	int32_t frac = u - ((uint16_t)i << TLI493D_JOYSTICK_LUT_SHIFT);
+	int16_t out = joystick->lut[i] + (((joystick->lut[i + 1] - joystick->lut[i]) * frac) >> TLI493D_JOYSTICK_LUT_SHIFT);
+	return negative ? -out : out;
+}
+
+void tli493d::initJoystick(Joystick_t *joystick)
+{
+	joystick->sumX = 0;
+	joystick->sumY = 0;
+	joystick->count = 0;
+	joystick->minX = INT16_MAX;
+	joystick->maxX = INT16_MIN;
+	joystick->minY = INT16_MAX;
+	joystick->maxY = INT16_MIN;
+}
+
+void tli493d::addJoystickCenter(Joystick_t *joystick, int16_t x, int16_t y)
+{
+	if (joystick->count == 0xFFFF)
+		return;
+	joystick->sumX += x;
+	joystick->sumY += y;
+	joystick->count++;
+}
+
+void tli493d::addJoystickExtent(Joystick_t *joystick, int16_t x, int16_t y)
+{
+	if (x < joystick->minX) joystick->minX = x;
+	if (x > joystick->maxX) joystick->maxX = x;
+	if (y < joystick->minY) joystick->minY = y;
+	if (y > joystick->maxY) joystick->maxY = y;
+}
+
+bool tli493d::finishJoystickCalibration(Joystick_t *joystick, uint16_t deadzone, uint8_t shape, float maxTilt)
+{
+	if (joystick->count == 0 || deadzone >= TLI493D_JOYSTICK_MAX)
+		return false;
+	joystick->centerX = joystick->sumX / joystick->count;
+	joystick->centerY = joystick->sumY / joystick->count;
+
+	int32_t ranges[4] = {joystick->maxX - joystick->centerX, joystick->centerX - joystick->minX,
+						 joystick->maxY - joystick->centerY, joystick->centerY - joystick->minY};
+	for (uint8_t i = 0; i < 4; i++)
+	{
+		if (ranges[i] <= 0)
+			return false;
+		//rounded up, so that the full extent reaches TLI493D_JOYSTICK_MAX
+		joystick->scale[i] = (((uint32_t)TLI493D_JOYSTICK_MAX << 16) + ranges[i] - 1) / ranges[i];
+	}
+
+	joystick->deadzone = deadzone;
+	joystick->deadzoneScale = (((uint32_t)TLI493D_JOYSTICK_MAX << 16) + TLI493D_JOYSTICK_MAX - deadzone - 1) /
+							  (TLI493D_JOYSTICK_MAX - deadzone);
+	joystick->shape = shape;
+
+	//field ~ sin(tilt): tilt / maxTilt = asin(u * sin(maxTilt)) / maxTilt
+	float tilt = maxTilt * M_PI / 180.0;
+	for (uint8_t i = 0; i < TLI493D_JOYSTICK_LUT_SIZE; i++)
+	{
+		float u = (float)i / (TLI493D_JOYSTICK_LUT_SIZE - 1);
+		float out = tilt > 0 ? asin(u * sin(tilt)) / tilt : u;
+		joystick->lut[i] = (int16_t)(out * TLI493D_JOYSTICK_MAX + 0.5);
+	}
+	return true;
+}
+
+void tli493d::getJoystick(const Joystick_t *joystick, int16_t x, int16_t y, int16_t *outX, int16_t *outY)
+{
+	int16_t u = mapAxis(joystick, x, joystick->centerX, joystick->minX, joystick->maxX, 0);
+	int16_t v = mapAxis(joystick, y, joystick->centerY, joystick->minY, joystick->maxY, 2);
+
+	if (joystick->shape == DEADZONE_CIRCLE)
+	{
+		if ((int32_t)u * u + (int32_t)v * v < (int32_t)joystick->deadzone * joystick->deadzone)
+			u = v = 0;
+	}
+	else
+	{
+		int16_t *axis[2] = {&u, &v};
+		for (uint8_t i = 0; i < 2; i++)
+		{
+			int16_t a = *axis[i] < 0 ? -*axis[i] : *axis[i];
+			a = a <= (int16_t)joystick->deadzone ? 0 :
+				(int16_t)min(((uint32_t)(a - joystick->deadzone) * joystick->deadzoneScale) >> 16, (uint32_t)TLI493D_JOYSTICK_MAX);
+			*axis[i] = *axis[i] < 0 ? -a : a;
+		}
+	}
+	*outX = u;
+	*outY = v;
+}
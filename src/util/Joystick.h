@@ -0,0 +1,76 @@
+#ifndef TLI493D_JOYSTICK_H_INCLUDED
+#define TLI493D_JOYSTICK_H_INCLUDED
+
+#include <Arduino.h>
+
+#define TLI493D_JOYSTICK_MAX		1024	//output range [-1024,1024]
+#define TLI493D_JOYSTICK_LUT_SHIFT	6		//input step of the lookup table: 64 counts
+#define TLI493D_JOYSTICK_LUT_SIZE	((TLI493D_JOYSTICK_MAX >> TLI493D_JOYSTICK_LUT_SHIFT) + 1)
+
+namespace tli493d
+{
+
+enum JoystickDeadzone_e
+{
+	DEADZONE_SQUARE = 0,	//per axis; the remaining deflection is rescaled to the full output range
+	DEADZONE_CIRCLE = 1		//both axes are zero inside the circle, unchanged outside
+};
+
+/**
+ * Magnetic joystick with a magnet above the sensor: Bx and By are mapped to a normalised tilt in both directions.
+ */
+typedef struct
+{
+	int16_t centerX;
+	int16_t centerY;
+	int16_t minX;
+	int16_t maxX;
+	int16_t minY;
+	int16_t maxY;
+	int32_t sumX;				//sums of the centre samples during calibration
+	int32_t sumY;
+	uint16_t count;
+	uint32_t scale[4];			//counts per LSB in Q16 for +x, -x, +y, -y
+	uint16_t deadzone;			//in output counts
+	uint32_t deadzoneScale;		//rescaling of the square deadzone in Q16
+	uint8_t shape;
+	int16_t lut[TLI493D_JOYSTICK_LUT_SIZE];
+} Joystick_t;
+
+/**
+ * @brief Starts the calibration
+ */
+void initJoystick(Joystick_t *joystick);
+
+/**
+ * @brief Calibration step 1: add samples with the joystick released
+ */
+void addJoystickCenter(Joystick_t *joystick, int16_t x, int16_t y);
+
+/**
+ * @brief Calibration step 2: add samples while the joystick is moved along its whole border
+ */
+void addJoystickExtent(Joystick_t *joystick, int16_t x, int16_t y);
+
+/**
+ * @brief Finishes the calibration and generates the linearisation table
+ * @param deadzone Size of the deadzone in output counts [0,TLI493D_JOYSTICK_MAX)
+ * @param shape DEADZONE_SQUARE or DEADZONE_CIRCLE
+ * @param maxTilt Tilt angle at full deflection in degree; the field follows the sine of the tilt, which is linearised.
+ * 		  0 keeps the output linear to the field.
+ * @return false if no centre samples were added or an extent is zero
+ */
+bool finishJoystickCalibration(Joystick_t *joystick, uint16_t deadzone, uint8_t shape, float maxTilt);
+
+/**
+ * @brief Maps a sample to the joystick position in integer math
+ * @param x Raw Bx in LSB
+ * @param y Raw By in LSB
+ * @param outX Returns the x position [-TLI493D_JOYSTICK_MAX,TLI493D_JOYSTICK_MAX]
+ * @param outY Returns the y position [-TLI493D_JOYSTICK_MAX,TLI493D_JOYSTICK_MAX]
+ */
+void getJoystick(const Joystick_t *joystick, int16_t x, int16_t y, int16_t *outX, int16_t *outY);
+
+}
+
+#endif
@@ -0,0 +1,175 @@
+#include "Kalman.h"
+#include <math.h>
+
+//logarithmic bin of a sample interval, 4 bins per octave
+static uint8_t intervalBin(uint32_t dt)
+{
+	if (dt < (1UL << TLI493D_KALMAN_MIN_SHIFT))
+		return 0;
+	//most significant bit by binary search
+	uint8_t msb = 0;
+	for (uint8_t step = 16; step != 0; step >>= 1)
+	{
+		if (dt >> (msb + step))
+			msb += step;
+	}
+	uint8_t bin = ((msb - TLI493D_KALMAN_MIN_SHIFT) << 2) | ((dt >> (msb - 2)) & 0x03);
+	return bin < TLI493D_KALMAN_BINS ? bin : TLI493D_KALMAN_BINS - 1;
+}
+
+void tli493d::initKalman(Kalman_t *kalman, float measurementNoise, float accelerationNoise, float gate, uint8_t maxOutliers)
+{
+	for (uint8_t i = 0; i < TLI493D_KALMAN_BINS; i++)
+	{
+		//geometric centre of the bin
+		uint8_t msb = (i >> 2) + TLI493D_KALMAN_MIN_SHIFT;
+		//unsigned long: the shift exceeds the 16 bit int of AVR from bin 36 (32ms) on
+		float low = (float)((4UL + (i & 0x03)) << (msb - 2));
+		float dt = sqrt(low * (low + (1UL << (msb - 2)))) * 1e-6;
+
+		//steady state of the alpha-beta filter from the tracking index (Kalata)
+		float lambda = accelerationNoise * dt * dt / measurementNoise;
+		float r = (4 + lambda - sqrt(8 * lambda + lambda * lambda)) / 4;
+		float alpha = 1 - r * r;
+		float beta = 2 * (2 - alpha) - 4 * sqrt(1 - alpha);
+
+		kalman->alpha[i] = (uint16_t)min(alpha * 65536.0f + 0.5f, 65535.0f);
+		kalman->beta[i] = (uint32_t)(beta / (dt * 1e6) * 4294967296.0);
+		//the innovation variance is measurement variance / (1 - alpha)
+		float limit = gate * measurementNoise / sqrt(max(1 - alpha, 1e-6f)) * (1 << TLI493D_KALMAN_POS_SHIFT);
+		kalman->gate[i] = gate > 0 ? (uint32_t)min(limit, 4.0e9f) : 0xFFFFFFFFUL;
+	}
+	kalman->maxOutliers = maxOutliers;
+	kalman->outliers = 0;
+	kalman->rejected = 0;
+	kalman->samples = 0;
+}
+
+bool tli493d::addToKalman(Kalman_t *kalman, uint32_t time, int16_t x, int16_t y, int16_t z)
+{
+	int16_t measurement[3] = {x, y, z};
+
+	uint32_t dt = time - kalman->time;
+	kalman->time = time;
+
+	//start: the first sample sets the field, the second one the rate
+	if (kalman->samples < 2)
+	{
+		for (uint8_t i = 0; i < 3; i++)
+		{
+			int32_t field = (int32_t)measurement[i] << TLI493D_KALMAN_POS_SHIFT;
+			kalman->rate[i] = kalman->samples == 0 || dt == 0 ? 0 :
+				(int32_t)(((int64_t)(field - kalman->field[i]) << (TLI493D_KALMAN_VEL_SHIFT - TLI493D_KALMAN_POS_SHIFT)) / (int32_t)dt);
+			kalman->field[i] = field;
+		}
+		kalman->samples++;
+		return true;
+	}
+
+	uint8_t bin = intervalBin(dt);
+
+	//prediction: field += rate * dt
+	int32_t innovation[3];
+	bool outlier = false;
+	for (uint8_t i = 0; i < 3; i++)
+	{
+		kalman->field[i] += (int32_t)(((int64_t)kalman->rate[i] * dt) >> (TLI493D_KALMAN_VEL_SHIFT - TLI493D_KALMAN_POS_SHIFT));
+		innovation[i] = ((int32_t)measurement[i] << TLI493D_KALMAN_POS_SHIFT) - kalman->field[i];
+		if ((uint32_t)labs(innovation[i]) > kalman->gate[bin])
+			outlier = true;
+	}
+
+	if (outlier)
+	{
+		if (kalman->rejected < 0xFFFF)
+			kalman->rejected++;
+		//a lasting change is not an outlier: restart from the measurement
+		if (++kalman->outliers >= kalman->maxOutliers && kalman->maxOutliers != 0)
+		{
+			kalman->samples = 0;
+			addToKalman(kalman, time, x, y, z);
+			kalman->outliers = 0;
+		}
+		return false;
+	}
+	kalman->outliers = 0;
+
+	//correction: field += alpha * innovation, rate += beta / dt * innovation
+	for (uint8_t i = 0; i < 3; i++)
+	{
+		kalman->field[i] += (int32_t)(((int64_t)innovation[i] * kalman->alpha[bin]) >> 16);
+		kalman->rate[i] += (int32_t)(((int64_t)innovation[i] * kalman->beta[bin]) >> (32 + TLI493D_KALMAN_POS_SHIFT - TLI493D_KALMAN_VEL_SHIFT));
+	}
+	return true;
+}
+
+void tli493d::getKalmanField(const Kalman_t *kalman, int16_t *x, int16_t *y, int16_t *z)
+{
+	int16_t *out[3] = {x, y, z};
+	for (uint8_t i = 0; i < 3; i++)
+	{
+		//rounded
+		int32_t value = (kalman->field[i] + (1 << (TLI493D_KALMAN_POS_SHIFT - 1))) >> TLI493D_KALMAN_POS_SHIFT;
+		*out[i] = constrain(value, -2048, 2047);
+	}
+}
+
+void tli493d::getKalmanRate(const Kalman_t *kalman, int32_t *x, int32_t *y, int32_t *z)
+{
+	int32_t *out[3] = {x, y, z};
+	for (uint8_t i = 0; i < 3; i++)
+		*out[i] = (int32_t)(((int64_t)kalman->rate[i] * 1000000) >> TLI493D_KALMAN_VEL_SHIFT);
+}
+
+void tli493d::initKalmanReference(KalmanReference_t *kalman, float measurementNoise, float accelerationNoise)
+{
+	kalman->measurementNoise = measurementNoise;
+	kalman->accelerationNoise = accelerationNoise;
+	kalman->initialized = false;
+}
+
+void tli493d::addToKalmanReference(KalmanReference_t *kalman, uint32_t time, int16_t x, int16_t y, int16_t z)
+{
+	float measurement[3] = {(float)x, (float)y, (float)z};
+	float r = kalman->measurementNoise * kalman->measurementNoise;
+
+	if (!kalman->initialized)
+	{
+		for (uint8_t i = 0; i < 3; i++)
+		{
+			kalman->field[i] = measurement[i];
+			kalman->rate[i] = 0;
+			//unknown rate: large initial variance
+			kalman->covariance[i][0] = r;
+			kalman->covariance[i][1] = 0;
+			kalman->covariance[i][2] = 1e12f;
+		}
+		kalman->time = time;
+		kalman->initialized = true;
+		return;
+	}
+
+	float dt = (time - kalman->time) * 1e-6f;
+	kalman->time = time;
+	float q = kalman->accelerationNoise * kalman->accelerationNoise;
+
+	for (uint8_t i = 0; i < 3; i++)
+	{
+		float *p = kalman->covariance[i];
+		//prediction with the white acceleration noise of the same model as initKalman()
+		kalman->field[i] += kalman->rate[i] * dt;
+		float p00 = p[0] + 2 * dt * p[1] + dt * dt * p[2] + q * dt * dt * dt * dt / 4;
+		float p01 = p[1] + dt * p[2] + q * dt * dt * dt / 2;
+		float p11 = p[2] + q * dt * dt;
+
+		float s = p00 + r;
+		float k0 = p00 / s;
+		float k1 = p01 / s;
+		float innovation = measurement[i] - kalman->field[i];
+		kalman->field[i] += k0 * innovation;
+		kalman->rate[i] += k1 * innovation;
+		p[0] = (1 - k0) * p00;
+		p[1] = (1 - k0) * p01;
+		p[2] = p11 - k1 * p01;
+	}
+}
@@ -0,0 +1,84 @@
+#ifndef TLI493D_KALMAN_H_INCLUDED
+#define TLI493D_KALMAN_H_INCLUDED
+
+#include <Arduino.h>
+
+#define TLI493D_KALMAN_MIN_SHIFT	6		//shortest tabulated sample interval: 64us
+#define TLI493D_KALMAN_BINS			48		//4 bins per octave, up to 262ms
+#define TLI493D_KALMAN_POS_SHIFT	8		//field in Q8 LSB
+#define TLI493D_KALMAN_VEL_SHIFT	24		//rate in Q24 LSB/us
+
+namespace tli493d
+{
+
+/**
+ * Constant velocity Kalman filter for Bx, By and Bz with steady-state gains. The gains only depend on the sample
+ * interval, so they are precomputed for logarithmic bins of the interval (alpha-beta filter with the gains of
+ * Kalata for white acceleration noise). An update takes a table lookup and a few 32/64 bit multiplications per axis.
+ */
+typedef struct
+{
+	uint16_t alpha[TLI493D_KALMAN_BINS];		//field gain in Q16
+	uint32_t beta[TLI493D_KALMAN_BINS];			//rate gain beta / dt in 1/us, Q32
+	uint32_t gate[TLI493D_KALMAN_BINS];			//largest innovation accepted in Q8 LSB
+	int32_t field[3];							//Q8 LSB
+	int32_t rate[3];							//Q24 LSB/us
+	uint32_t time;								//time of the last update in us
+	uint8_t maxOutliers;						//consecutive outliers after which the filter restarts
+	uint8_t outliers;							//current consecutive outliers
+	uint16_t rejected;							//total rejected samples
+	uint8_t samples;							//0 and 1 while starting, 2 when running
+} Kalman_t;
+
+/**
+ * Reference implementation in float with the full covariance per axis, e.g. to check the accuracy on the host
+ */
+typedef struct
+{
+	float field[3];
+	float rate[3];			//LSB/s
+	float covariance[3][3];	//field-field, field-rate, rate-rate per axis
+	float measurementNoise;
+	float accelerationNoise;
+	uint32_t time;
+	bool initialized;
+} KalmanReference_t;
+
+/**
+ * @brief Precomputes the gains; floating point is only used here
+ * @param measurementNoise Standard deviation of the field in LSB, e.g. from the statistics
+ * @param accelerationNoise Standard deviation of the change of the rate in LSB/s^2: higher follows faster, lower smooths more
+ * @param gate Innovation in standard deviations above which a sample is rejected, 0 disables the rejection
+ * @param maxOutliers Consecutive rejected samples after which the filter restarts from the measurement, e.g. after a jump
+ */
+void initKalman(Kalman_t *kalman, float measurementNoise, float accelerationNoise, float gate, uint8_t maxOutliers);
+
+/**
+ * @brief Predicts with the interval since the last sample and corrects with the measurement; integer math only.
+ * 		  The first sample initialises the field, the second one the rate.
+ * @param time Time of the sample in us, e.g. micros()
+ * @param x, y, z Raw field in LSB
+ * @return false if the sample was rejected as outlier; the filter is then only predicted
+ */
+bool addToKalman(Kalman_t *kalman, uint32_t time, int16_t x, int16_t y, int16_t z);
+
+/**
+ * @brief Returns the filtered field in LSB
+ */
+void getKalmanField(const Kalman_t *kalman, int16_t *x, int16_t *y, int16_t *z);
+
+/**
+ * @brief Returns the filtered rate of the field in LSB/s
+ */
+void getKalmanRate(const Kalman_t *kalman, int32_t *x, int32_t *y, int32_t *z);
+
+void initKalmanReference(KalmanReference_t *kalman, float measurementNoise, float accelerationNoise);
+
+/**
+ * @brief Float Kalman filter with the same model, covariance propagated with the exact interval
+ */
+void addToKalmanReference(KalmanReference_t *kalman, uint32_t time, int16_t x, int16_t y, int16_t z);
+
+}
+
+#endif
@@ -0,0 +1,109 @@
+#include "Knob.h"
+#include "IntMath.h"
+
+void tli493d::initKnob(Knob_t *knob, int16_t x, int16_t y, int16_t z, uint8_t detents, uint8_t hysteresis,
+					   uint16_t pushThreshold, uint16_t tiltThreshold, uint8_t debounce)
+{
+	if (detents < 2)
+		detents = 2;
+	knob->detentWidth = (Bam_t)(65536UL / detents);
+	knob->hysteresis = (Bam_t)(((uint32_t)knob->detentWidth * hysteresis) >> 8);
+	knob->restNorm = sqrtInt((int32_t)x * x + (int32_t)y * y + (int32_t)z * z);
+	knob->restZ = z;
+	knob->pushThreshold = pushThreshold;
+	knob->tiltThreshold = tiltThreshold;
+	knob->debounce = debounce == 0 ? 1 : debounce;
+	knob->center = atan2Int(y, x);
+	knob->position = 0;
+	knob->steps = 0;
+	knob->pushCount = 0;
+	knob->tiltCount = 0;
+	knob->pushed = false;
+	knob->tilted = false;
+	knob->pushEvents = 0;
+	knob->tiltEvents = 0;
+	knob->tiltDirection = 0;
+}
+
+void tli493d::addToKnob(Knob_t *knob, int16_t x, int16_t y, int16_t z)
+{
+	Bam_t angle = atan2Int(y, x);
+	uint16_t norm = sqrtInt((int32_t)x * x + (int32_t)y * y + (int32_t)z * z);
+
+	//detents: step when the angle is beyond the border to the next detent plus hysteresis
+	int32_t limit = (knob->detentWidth >> 1) + knob->hysteresis;
+	int16_t diff = (int16_t)(angle - knob->center);
+	while (diff > limit || diff < -limit)
+	{
+		int8_t step = diff > 0 ? 1 : -1;
+		knob->center += step * knob->detentWidth;
+		knob->position += step;
+		knob->steps += step;
+		diff = (int16_t)(angle - knob->center);
+	}
+
+	//push and release, debounced; the release threshold is lower to avoid chatter
+	int32_t rise = (int32_t)norm - knob->restNorm;
+	bool change = knob->pushed ? rise < (knob->pushThreshold >> 1) : rise > knob->pushThreshold;
+	knob->pushCount = change ? knob->pushCount + 1 : 0;
+	if (knob->pushCount >= knob->debounce)
+	{
+		knob->pushed = !knob->pushed;
+		knob->pushEvents = knob->pushEvents >= 2 ? 1 : knob->pushEvents + 1;
+		knob->pushCount = 0;
+	}
+
+	//tilt: the raised pole points along the in-plane field for an increase of Bz, opposite for a decrease
+	int32_t dz = (int32_t)z - knob->restZ;
+	uint16_t adz = dz < 0 ? -dz : dz;
+	change = knob->tilted ? adz < (knob->tiltThreshold >> 1) : adz > knob->tiltThreshold;
+	knob->tiltCount = change ? knob->tiltCount + 1 : 0;
+	if (knob->tiltCount >= knob->debounce)
+	{
+		knob->tilted = !knob->tilted;
+		knob->tiltEvents = knob->tiltEvents >= 2 ? 1 : knob->tiltEvents + 1;
+		knob->tiltCount = 0;
+		if (knob->tilted)
+			knob->tiltDirection = dz > 0 ? angle : angle + TLI493D_BAM_HALF;
+	}
+}
+
+bool tli493d::getKnobEvent(Knob_t *knob, KnobEvent_t *event)
+{
+	event->position = knob->position - knob->steps;
+	event->value = 0;
+
+	//with two changes pending, the first one led to the opposite of the current state
+	if (knob->pushEvents != 0)
+	{
+		bool pushed = knob->pushEvents == 2 ? !knob->pushed : knob->pushed;
+		knob->pushEvents--;
+		event->type = pushed ? KNOB_PUSH : KNOB_RELEASE;
+	}
+	else if (knob->tiltEvents != 0)
+	{
+		bool tilted = knob->tiltEvents == 2 ? !knob->tilted : knob->tilted;
+		knob->tiltEvents--;
+		event->type = tilted ? KNOB_TILT : KNOB_UNTILT;
+		event->value = (int16_t)knob->tiltDirection;
+	}
+	else if (knob->steps != 0)
+	{
+		int8_t step = knob->steps > 0 ? 1 : -1;
+		knob->steps -= step;
+		event->type = KNOB_DETENT;
+		event->value = step;
+		event->position += step;
+	}
+	else
+	{
+		event->type = KNOB_NONE;
+		return false;
+	}
+	return true;
+}
+
+bool tli493d::knobIdle(const Knob_t *knob)
+{
+	return !knob->pushed && !knob->tilted && knob->pushEvents == 0 && knob->tiltEvents == 0 && knob->steps == 0;
+}
@@ -0,0 +1,86 @@
+#ifndef TLI493D_KNOB_H_INCLUDED
+#define TLI493D_KNOB_H_INCLUDED
+
+#include <Arduino.h>
+#include "IntMath.h"
+
+namespace tli493d
+{
+
+enum KnobEvent_e
+{
+	KNOB_NONE = 0,
+	KNOB_DETENT = 1,	//one detent step, value is +1 (counter-clockwise seen from the magnet) or -1
+	KNOB_PUSH = 2,
+	KNOB_RELEASE = 3,
+	KNOB_TILT = 4,		//value is the direction of the tilt as binary angle (cast to Bam_t)
+	KNOB_UNTILT = 5
+};
+
+typedef struct
+{
+	uint8_t type;		//@ref KnobEvent_e
+	int32_t position;	//detent position after the event
+	int16_t value;
+} KnobEvent_t;
+
+/**
+ * Event detector for a knob with a diametrically magnetised magnet above the sensor: turning rotates Bx/By, pushing
+ * moves the magnet closer and increases the norm, tilting raises one pole and changes Bz. Tilting around the axis of the
+ * magnetisation does not change the field and is not detected. All processing is in integer math.
+ */
+typedef struct
+{
+	Bam_t detentWidth;			//full circle / detents
+	Bam_t hysteresis;			//angle beyond the border between two detents needed for a step
+	uint16_t restNorm;			//norm at rest in LSB
+	int16_t restZ;				//Bz at rest in LSB
+	uint16_t pushThreshold;		//increase of the norm for a push in LSB, the release is at half of it
+	uint16_t tiltThreshold;		//change of Bz for a tilt in LSB, the end of the tilt is at half of it
+	uint8_t debounce;			//consecutive samples needed for push, release, tilt and end of tilt
+	Bam_t center;				//angle of the current detent
+	int32_t position;			//detent position
+	int16_t steps;				//detent steps not yet reported
+	uint8_t pushCount;
+	uint8_t tiltCount;
+	bool pushed;
+	bool tilted;
+	uint8_t pushEvents;			//changes between pushed and released not yet reported, at most 2
+	uint8_t tiltEvents;			//changes between tilted and not tilted not yet reported, at most 2
+	Bam_t tiltDirection;
+} Knob_t;
+
+/**
+ * @brief Initialises the detector with a sample of the knob at rest, which becomes the centre of detent 0
+ * @param x, y, z Raw field in LSB
+ * @param detents Detents per revolution [2,255]
+ * @param hysteresis Hysteresis in 1/256 of a detent, e.g. 32 to step 1/8 detent after the border
+ * @param pushThreshold Increase of the norm for a push in LSB
+ * @param tiltThreshold Change of Bz for a tilt in LSB
+ * @param debounce Consecutive samples needed for push, release and tilt, at least 1
+ */
+void initKnob(Knob_t *knob, int16_t x, int16_t y, int16_t z, uint8_t detents, uint8_t hysteresis,
+			  uint16_t pushThreshold, uint16_t tiltThreshold, uint8_t debounce);
+
+/**
+ * @brief Adds a sample, e.g. after each updateData()
+ */
+void addToKnob(Knob_t *knob, int16_t x, int16_t y, int16_t z);
+
+/**
+ * @brief Returns the next pending event: push and release first, then tilt, then one detent step per call.
+ * 		  Call it until it returns false after each sample.
+ * @return true if an event was returned
+ */
+bool getKnobEvent(Knob_t *knob, KnobEvent_t *event);
+
+/**
+ * @brief The knob is idle if it is neither pushed nor tilted and all events are reported. Then the microcontroller can
+ * 		  sleep until the next wake-up interrupt, e.g. with a tracking wake-up window (Tli493d::enableWakeUpTracking())
+ * 		  smaller than the field change of a detent.
+ */
+bool knobIdle(const Knob_t *knob);
+
+}
+
+#endif
@@ -0,0 +1,172 @@
+#include "Localize.h"
+#include <math.h>
+
+using tli493d::LocalizeReal_t;
+
+//dipole field at r (point - position) and optionally its 3x6 Jacobian with respect to position and moment
+static void dipole(const LocalizeReal_t (&r)[3], const LocalizeReal_t (&m)[3], LocalizeReal_t (&b)[3], LocalizeReal_t (*jacobian)[6])
+{
+	LocalizeReal_t r2 = r[0] * r[0] + r[1] * r[1] + r[2] * r[2];
+	LocalizeReal_t inv2 = 1 / r2;
+	LocalizeReal_t inv3 = inv2 / sqrt(r2);
+	LocalizeReal_t inv5 = inv3 * inv2;
+	LocalizeReal_t mr = m[0] * r[0] + m[1] * r[1] + m[2] * r[2];
+
+	for (uint8_t i = 0; i < 3; i++)
+		b[i] = 3 * mr * r[i] * inv5 - m[i] * inv3;
+	if (jacobian == NULL)
+		return;
+
+	for (uint8_t i = 0; i < 3; i++)
+	{
+		for (uint8_t j = 0; j < 3; j++)
+		{
+			LocalizeReal_t delta = i == j ? 1 : 0;
+			//dB/dr = 3/r^5 (r m^T + m r^T + (m.r) I) - 15 (m.r) r r^T / r^7; the position enters as -r
+			LocalizeReal_t dr = 3 * inv5 * (r[i] * m[j] + m[i] * r[j] + mr * delta) - 15 * mr * r[i] * r[j] * inv5 * inv2;
+			jacobian[i][j] = -dr;
+			//dB/dm = 3 r r^T / r^5 - I / r^3
+			jacobian[i][j + 3] = 3 * r[i] * r[j] * inv5 - delta * inv3;
+		}
+	}
+}
+
+static LocalizeReal_t residual(const LocalizeReal_t (&p)[3], const LocalizeReal_t (&m)[3], const float (*sensors)[3],
+							   const float (*field)[3], uint8_t count)
+{
+	LocalizeReal_t cost = 0;
+	for (uint8_t k = 0; k < count; k++)
+	{
+		LocalizeReal_t r[3] = {sensors[k][0] - p[0], sensors[k][1] - p[1], sensors[k][2] - p[2]};
+		LocalizeReal_t b[3];
+		dipole(r, m, b, NULL);
+		for (uint8_t i = 0; i < 3; i++)
+			cost += (b[i] - field[k][i]) * (b[i] - field[k][i]);
+	}
+	return cost;
+}
+
+//solves a x = g for a symmetric positive definite 6x6 matrix by Cholesky decomposition, a is overwritten
+static bool solve6(LocalizeReal_t (&a)[6][6], const LocalizeReal_t (&g)[6], LocalizeReal_t (&x)[6])
+{
+	for (uint8_t j = 0; j < 6; j++)
+	{
+		LocalizeReal_t d = a[j][j];
+		for (uint8_t k = 0; k < j; k++)
+			d -= a[j][k] * a[j][k];
+		if (!(d > 0))
+			return false;
+		a[j][j] = sqrt(d);
+		for (uint8_t i = j + 1; i < 6; i++)
+		{
+			LocalizeReal_t s = a[i][j];
+			for (uint8_t k = 0; k < j; k++)
+				s -= a[i][k] * a[j][k];
+			a[i][j] = s / a[j][j];
+		}
+	}
+	for (uint8_t i = 0; i < 6; i++)
+	{
+		LocalizeReal_t s = g[i];
+		for (uint8_t k = 0; k < i; k++)
+			s -= a[i][k] * x[k];
+		x[i] = s / a[i][i];
+	}
+	for (int8_t i = 5; i >= 0; i--)
+	{
+		LocalizeReal_t s = x[i];
+		for (uint8_t k = i + 1; k < 6; k++)
+			s -= a[k][i] * x[k];
+		x[i] = s / a[i][i];
+	}
+	return true;
+}
+
+void tli493d::initLocalize(Localize_t *loc, const float (&position)[3], const float (&moment)[3])
+{
+	for (uint8_t i = 0; i < 3; i++)
+	{
+		loc->position[i] = position[i];
+		loc->moment[i] = moment[i];
+	}
+	loc->lambda = TLI493D_LOCALIZE_LAMBDA;
+	loc->cost = -1;
+	loc->iterations = 0;
+}
+
+LocalizeReal_t tli493d::localize(Localize_t *loc, const float (*sensors)[3], const float (*field)[3], uint8_t count, uint8_t iterations)
+{
+	if (count < 2)
+		return -1;
+
+	//the field has changed since the last frame
+	LocalizeReal_t cost = residual(loc->position, loc->moment, sensors, field, count);
+	loc->iterations = 0;
+
+	while (loc->iterations < iterations)
+	{
+		loc->iterations++;
+
+		//normal equations J^T J and J^T (measured - model), accumulated per sensor
+		LocalizeReal_t a[6][6] = {{0}};
+		LocalizeReal_t g[6] = {0};
+		for (uint8_t k = 0; k < count; k++)
+		{
+			LocalizeReal_t r[3] = {sensors[k][0] - loc->position[0], sensors[k][1] - loc->position[1], sensors[k][2] - loc->position[2]};
+			LocalizeReal_t b[3];
+			LocalizeReal_t jacobian[3][6];
+			dipole(r, loc->moment, b, jacobian);
+			for (uint8_t c = 0; c < 3; c++)
+			{
+				LocalizeReal_t e = field[k][c] - b[c];
+				for (uint8_t i = 0; i < 6; i++)
+				{
+					g[i] += jacobian[c][i] * e;
+					for (uint8_t j = 0; j <= i; j++)
+						a[i][j] += jacobian[c][i] * jacobian[c][j];
+				}
+			}
+		}
+		//damping scaled with the diagonal (Marquardt), only the lower triangle is used
+		for (uint8_t i = 0; i < 6; i++)
+			a[i][i] += loc->lambda * a[i][i];
+
+		LocalizeReal_t step[6];
+		if (!solve6(a, g, step))
+		{
+			loc->lambda = min(loc->lambda * 10, (LocalizeReal_t)TLI493D_LOCALIZE_LAMBDA_MAX);
+			continue;
+		}
+
+		LocalizeReal_t p[3], m[3];
+		for (uint8_t i = 0; i < 3; i++)
+		{
+			p[i] = loc->position[i] + step[i];
+			m[i] = loc->moment[i] + step[i + 3];
+		}
+		LocalizeReal_t newCost = residual(p, m, sensors, field, count);
+		if (newCost < cost)
+		{
+			for (uint8_t i = 0; i < 3; i++)
+			{
+				loc->position[i] = p[i];
+				loc->moment[i] = m[i];
+			}
+			cost = newCost;
+			loc->lambda = max(loc->lambda / 10, (LocalizeReal_t)TLI493D_LOCALIZE_LAMBDA_MIN);
+		}
+		else
+		{
+			loc->lambda = min(loc->lambda * 10, (LocalizeReal_t)TLI493D_LOCALIZE_LAMBDA_MAX);
+		}
+	}
+
+	loc->cost = cost;
+	return sqrt(cost / (3 * count));
+}
+
+void tli493d::dipoleField(const LocalizeReal_t (&position)[3], const LocalizeReal_t (&moment)[3], const float (&point)[3], LocalizeReal_t (&field)[3])
+{
+	LocalizeReal_t r[3] = {point[0] - position[0], point[1] - position[1], point[2] - position[2]};
+	dipole(r, moment, field, NULL);
+}
@@ -0,0 +1,64 @@
+#ifndef TLI493D_LOCALIZE_H_INCLUDED
+#define TLI493D_LOCALIZE_H_INCLUDED
+
+#include <Arduino.h>
+
+//0: single precision, fast on Cortex-M4F; 1: double precision, e.g. as reference on the host
+#ifndef TLI493D_LOCALIZE_DOUBLE
+#define TLI493D_LOCALIZE_DOUBLE		0
+#endif
+
+#define TLI493D_LOCALIZE_LAMBDA		1e-3	//initial damping of Levenberg-Marquardt
+#define TLI493D_LOCALIZE_LAMBDA_MIN	1e-6
+#define TLI493D_LOCALIZE_LAMBDA_MAX	1e6
+
+namespace tli493d
+{
+
+#if TLI493D_LOCALIZE_DOUBLE
+typedef double LocalizeReal_t;
+#else
+typedef float LocalizeReal_t;
+#endif
+
+/**
+ * Position and moment of a magnet, fitted with the dipole model B = (3 (m.r) r / |r|^5 - m / |r|^3) to the field
+ * vectors of a sensor array. The state is kept between frames, so the solver is warm started from the last solution.
+ * Units are those of the arguments, e.g. mm and mT; the moment then is in mT*mm^3 (mu0/4pi included).
+ */
+typedef struct
+{
+	LocalizeReal_t position[3];		//position of the magnet
+	LocalizeReal_t moment[3];		//magnetic moment
+	LocalizeReal_t lambda;			//damping, adapted between iterations
+	LocalizeReal_t cost;			//sum of squared residuals of the last solution
+	uint8_t iterations;				//iterations of the last call, including rejected steps
+} Localize_t;
+
+/**
+ * @brief Sets the start values; the magnet must not be at a sensor position
+ * @param position Estimated position of the magnet
+ * @param moment Estimated moment, e.g. from the dipole constant of util/Dipole along the magnet axis
+ */
+void initLocalize(Localize_t *loc, const float (&position)[3], const float (&moment)[3]);
+
+/**
+ * @brief Refines position and moment with Levenberg-Marquardt iterations. A step that does not reduce the residual is
+ * 		  rejected and the damping increased. Per iteration the cost is O(count) for the normal equations plus a 6x6 Cholesky
+ * 		  decomposition; with a warm start from the previous frame one or two iterations are usually enough.
+ * @param sensors Positions of the sensors, at least 2
+ * @param field Measured field vectors of the sensors, e.g. with the earth field and offsets removed
+ * @param count Number of sensors
+ * @param iterations Maximum number of iterations
+ * @return root mean square of the residual per field component
+ */
+LocalizeReal_t localize(Localize_t *loc, const float (*sensors)[3], const float (*field)[3], uint8_t count, uint8_t iterations);
+
+/**
+ * @brief Field of the dipole at a point, e.g. to simulate an array
+ */
+void dipoleField(const LocalizeReal_t (&position)[3], const LocalizeReal_t (&moment)[3], const float (&point)[3], LocalizeReal_t (&field)[3]);
+
+}
+
+#endif
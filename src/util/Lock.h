@@ -0,0 +1,52 @@
+#ifndef TLI493D_LOCK_H_INCLUDED
+#define TLI493D_LOCK_H_INCLUDED
+
+#include <Arduino.h>
+
+//orders the sample writes against the sequence counter, also between cores
+#define TLI493D_MEMORY_BARRIER()	__sync_synchronize()
+
+namespace tli493d
+{
+
+/**
+ * Pluggable mutex, e.g. for FreeRTOS:
+ * 		void lock(void *m) { xSemaphoreTakeRecursive((SemaphoreHandle_t)m, portMAX_DELAY); }
+ * 		void unlock(void *m) { xSemaphoreGiveRecursive((SemaphoreHandle_t)m); }
+ * 		tli493d::Lock_t configLock = {lock, unlock, xSemaphoreCreateRecursiveMutex()};
+ */
+typedef struct
+{
+	void (*lock)(void *mutex);
+	void (*unlock)(void *mutex);
+	void *mutex;
+} Lock_t;
+
+/**
+ * Holds a lock for the lifetime of the object; does nothing without a lock
+ */
+class LockGuard
+{
+  public:
+	LockGuard(const Lock_t *lock) : mLock(lock)
+	{
+		if (mLock != NULL)
+			mLock->lock(mLock->mutex);
+	}
+
+	~LockGuard(void)
+	{
+		if (mLock != NULL)
+			mLock->unlock(mLock->mutex);
+	}
+
+  private:
+	const Lock_t *mLock;
+
+	LockGuard(const LockGuard &);
+	LockGuard &operator=(const LockGuard &);
+};
+
+}
+
+#endif
@@ -0,0 +1,109 @@
+#include "PositionLut.h"
+
+static uint16_t getKey(const tli493d::PositionLut_t *lut, uint8_t i)
+{
+	return lut->flash ? (uint16_t)TLI493D_READ_WORD((const int16_t *)&lut->points[i].key) : lut->points[i].key;
+}
+
+static int16_t getPos(const tli493d::PositionLut_t *lut, uint8_t i)
+{
+	return lut->flash ? TLI493D_READ_WORD(&lut->points[i].position) : lut->points[i].position;
+}
+
+uint16_t tli493d::getPositionKey(int16_t a, int16_t b)
+{
+	return pseudoAngle(b, a);
+}
+
+bool tli493d::finishPositionLut(PositionLut_t *lut, PositionPoint_t *points, uint8_t count)
+{
+	if (count < 2)
+		return false;
+
+	//move the middle of the travel to half the circle
+	uint16_t middle = points[0].key + (int16_t)(points[count - 1].key - points[0].key) / 2;
+	uint16_t rotation = 32768U - middle;
+	for (uint8_t i = 0; i < count; i++)
+		points[i].key += rotation;
+
+	//insertion sort, the points are nearly sorted anyway
+	for (uint8_t i = 1; i < count; i++)
+	{
+		PositionPoint_t p = points[i];
+		uint8_t j = i;
+		for (; j > 0 && points[j - 1].key > p.key; j--)
+			points[j] = points[j - 1];
+		points[j] = p;
+	}
+
+	bool rising = points[1].position > points[0].position;
+	for (uint8_t i = 1; i < count; i++)
+	{
+		if (points[i].key == points[i - 1].key ||
+			points[i].position == points[i - 1].position ||
+			(points[i].position > points[i - 1].position) != rising)
+			return false;
+	}
+
+	lut->points = points;
+	lut->count = count;
+	lut->rotation = rotation;
+	lut->flash = false;
+	return true;
+}
+
+void tli493d::initPositionLut(PositionLut_t *lut, const PositionPoint_t *points, uint8_t count, uint16_t rotation)
+{
+	lut->points = points;
+	lut->count = count;
+	lut->rotation = rotation;
+	lut->flash = true;
+}
+
+int16_t tli493d::getPosition(const PositionLut_t *lut, int16_t a, int16_t b)
+{
+	uint16_t key = getPositionKey(a, b) + lut->rotation;
+	uint8_t low = 0;
+	uint8_t high = lut->count - 1;
+
+	if (key <= getKey(lut, low))
+		return getPos(lut, low);
+	if (key >= getKey(lut, high))
+		return getPos(lut, high);
+
+	//key[low] < key < key[high]
+	while (high - low > 1)
+	{
+		uint8_t mid = (low + high) >> 1;
+		if (getKey(lut, mid) <= key)
+			low = mid;
+		else
+			high = mid;
+	}
+
+	uint16_t k0 = getKey(lut, low);
+	int16_t p0 = getPos(lut, low);
+	int32_t dp = (int32_t)getPos(lut, high) - p0;
+	//|dp| and the key difference are below 2^16, so the magnitude fits in 32 bits without a 64 bit division
+	int32_t step = (uint32_t)labs(dp) * (uint16_t)(key - k0) / (uint16_t)(getKey(lut, high) - k0);
+	return (int16_t)(p0 + (dp < 0 ? -step : step));
+}
+
+void tli493d::printPositionLut(const PositionLut_t *lut, Print &out)
+{
+	out.print("const tli493d::PositionPoint_t positionTable[] TLI493D_PROGMEM = {");
+	for (uint8_t i = 0; i < lut->count; i++)
+	{
+		out.print(i % 8 == 0 ? "\n\t{" : " {");
+		out.print(getKey(lut, i));
+		out.print(", ");
+		out.print(getPos(lut, i));
+		out.print("},");
+	}
+	out.println("\n};");
+	out.print("//initPositionLut(&lut, positionTable, ");
+	out.print(lut->count);
+	out.print(", ");
+	out.print(lut->rotation);
+	out.println(");");
+}
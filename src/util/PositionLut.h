@@ -0,0 +1,63 @@
+#ifndef TLI493D_POSITIONLUT_H_INCLUDED
+#define TLI493D_POSITIONLUT_H_INCLUDED
+
+#include <Arduino.h>
+#include "IntMath.h"
+
+namespace tli493d
+{
+
+/**
+ * Calibration point: key of the field ratio and the position in a unit of choice, e.g. 0.01 mm
+ */
+typedef struct
+{
+	uint16_t key;
+	int16_t position;
+} PositionPoint_t;
+
+/**
+ * Lookup table from the angle of two field axes to a linear position. The table can be kept in RAM or, after it has been
+ * printed with printPositionLut(), be compiled into flash as TLI493D_PROGMEM.
+ */
+typedef struct
+{
+	const PositionPoint_t *points;	//sorted by key
+	uint8_t count;
+	uint16_t rotation;				//added to the key, so that the travel is far from the wrap-around
+	bool flash;						//points are stored with TLI493D_PROGMEM
+} PositionLut_t;
+
+/**
+ * @return the key of a field vector: pseudo angle of (a, b), see tli493d::pseudoAngle()
+ */
+uint16_t getPositionKey(int16_t a, int16_t b);
+
+/**
+ * @brief Finishes a calibration. The points are rotated and sorted by key in place.
+ * @param points Calibration points with keys from getPositionKey(), in order of the travel
+ * @param count Number of points, at least 2
+ * @return false if the position is not strictly monotonic in the key
+ */
+bool finishPositionLut(PositionLut_t *lut, PositionPoint_t *points, uint8_t count);
+
+/**
+ * @brief Uses a table which was printed by printPositionLut() and is stored in flash
+ */
+void initPositionLut(PositionLut_t *lut, const PositionPoint_t *points, uint8_t count, uint16_t rotation);
+
+/**
+ * @brief Binary search and linear interpolation. Outside of the calibrated travel the end positions are returned.
+ * @param a First field axis in LSB, e.g. Bx
+ * @param b Second field axis in LSB, e.g. Bz
+ */
+int16_t getPosition(const PositionLut_t *lut, int16_t a, int16_t b);
+
+/**
+ * @brief Prints the table as source code, which can be copied into a sketch to keep it in flash
+ */
+void printPositionLut(const PositionLut_t *lut, Print &out);
+
+}
+
+#endif
@@ -0,0 +1,126 @@
+#include "Predictor.h"
+#include "IntMath.h"
+#include <string.h>
+
+//keeps the compiler from moving the model writes behind the update of the sequence
+#define TLI493D_COMPILER_BARRIER()	__asm__ __volatile__("" ::: "memory")
+
+//difference of two values of a channel, the angle wraps around
+static int32_t channelDelta(uint8_t channel, int16_t newer, int16_t older)
+{
+	if (channel == tli493d::PREDICT_ANGLE)
+		return (int16_t)((tli493d::Bam_t)newer - (tli493d::Bam_t)older);
+	return (int32_t)newer - older;
+}
+
+//consistent copy of the current model
+static void snapshot(const tli493d::Predictor_t *predictor, tli493d::PredictorModel_t *model)
+{
+	uint8_t sequence;
+	do
+	{
+		sequence = predictor->sequence;
+		TLI493D_COMPILER_BARRIER();
+		*model = predictor->model[sequence & 1];
+		TLI493D_COMPILER_BARRIER();
+		//one update writes the other buffer, only a second one may have overwritten this copy
+	} while ((uint8_t)(predictor->sequence - sequence) >= 2);
+}
+
+//value + velocity * dt + acceleration * dt^2 / 2
+static int32_t evaluate(const tli493d::PredictorChannel_t *channel, int32_t dt)
+{
+	//in Q16, so acceleration * dt^2 does not overflow
+	int64_t value = ((int64_t)channel->value << 16) + ((channel->velocity * dt) >> 16);
+	value += ((channel->acceleration * dt) >> 16) * dt >> 1;
+	return (int32_t)(value >> 16);
+}
+
+//time since the acquisition, limited to the horizon
+static int32_t horizon(const tli493d::Predictor_t *predictor, const tli493d::PredictorModel_t *model, uint32_t time)
+{
+	int32_t dt = (int32_t)(time - model->time);
+	int32_t limit = (int32_t)predictor->maxHorizon;
+	return constrain(dt, -limit, limit);
+}
+
+void tli493d::initPredictor(Predictor_t *predictor, uint8_t order, uint32_t latency, uint32_t maxHorizon)
+{
+	memset(predictor, 0, sizeof(Predictor_t));
+	predictor->order = order > PREDICT_QUADRATIC ? (uint8_t)PREDICT_QUADRATIC : order;
+	predictor->latency = latency;
+	predictor->maxHorizon = maxHorizon > 0x7FFFFFFF ? 0x7FFFFFFF : maxHorizon;
+}
+
+void tli493d::addToPredictor(Predictor_t *predictor, uint32_t time, int16_t x, int16_t y, int16_t z)
+{
+	int16_t sample[4] = {(int16_t)atan2Int(y, x), x, y, z};
+	time -= predictor->latency;
+
+	PredictorModel_t *model = &predictor->model[(predictor->sequence + 1) & 1];
+	model->time = time;
+	uint32_t dt1 = time - predictor->historyTime[1];
+	uint32_t dt0 = predictor->historyTime[1] - predictor->historyTime[0];
+	uint8_t order = predictor->order;
+	if (predictor->count < order)
+		order = predictor->count;
+	//samples with the same timestamp carry no velocity
+	if (dt1 == 0 || (order == PREDICT_QUADRATIC && dt0 == 0))
+		order = PREDICT_HOLD;
+
+	for (uint8_t i = 0; i < 4; i++)
+	{
+		PredictorChannel_t *channel = &model->channel[i];
+		channel->value = sample[i];
+		channel->velocity = 0;
+		channel->acceleration = 0;
+		if (order >= PREDICT_LINEAR)
+		{
+			//slopes between the samples in Q32
+			int64_t slope1 = ((int64_t)channelDelta(i, sample[i], predictor->history[1][i]) << 32) / (int32_t)dt1;
+			channel->velocity = slope1;
+			if (order == PREDICT_QUADRATIC)
+			{
+				int64_t slope0 = ((int64_t)channelDelta(i, predictor->history[1][i], predictor->history[0][i]) << 32) / (int32_t)dt0;
+				channel->acceleration = 2 * (slope1 - slope0) / (int32_t)(dt1 + dt0);
+				//the slope is the velocity in the middle of the last interval
+				channel->velocity += channel->acceleration * (int32_t)dt1 / 2;
+			}
+		}
+	}
+	TLI493D_COMPILER_BARRIER();
+	predictor->sequence++;
+
+	predictor->historyTime[0] = predictor->historyTime[1];
+	predictor->historyTime[1] = time;
+	for (uint8_t i = 0; i < 4; i++)
+	{
+		predictor->history[0][i] = predictor->history[1][i];
+		predictor->history[1][i] = sample[i];
+	}
+	if (predictor->count < 2)
+		predictor->count++;
+}
+
+tli493d::Bam_t tli493d::predictAngle(const Predictor_t *predictor, uint32_t time)
+{
+	PredictorModel_t model;
+	snapshot(predictor, &model);
+	return (Bam_t)evaluate(&model.channel[PREDICT_ANGLE], horizon(predictor, &model, time));
+}
+
+bool tli493d::predictField(const Predictor_t *predictor, uint32_t time, int16_t *x, int16_t *y, int16_t *z)
+{
+	PredictorModel_t model;
+	snapshot(predictor, &model);
+	if (predictor->count == 0)
+	{
+		*x = *y = *z = 0;
+		return false;
+	}
+	int32_t dt = horizon(predictor, &model, time);
+	*x = constrain(evaluate(&model.channel[PREDICT_X], dt), -2048, 2047);
+	*y = constrain(evaluate(&model.channel[PREDICT_Y], dt), -2048, 2047);
+	*z = constrain(evaluate(&model.channel[PREDICT_Z], dt), -2048, 2047);
+	return true;
+}
@@ -0,0 +1,89 @@
+#ifndef TLI493D_PREDICTOR_H_INCLUDED
+#define TLI493D_PREDICTOR_H_INCLUDED
+
+#include <Arduino.h>
+#include "IntMath.h"
+
+namespace tli493d
+{
+
+enum PredictorOrder_e
+{
+	PREDICT_HOLD = 0,		//last value
+	PREDICT_LINEAR = 1,		//value and velocity from the last two samples
+	PREDICT_QUADRATIC = 2	//value, velocity and acceleration from the last three samples
+};
+
+enum PredictorChannel_e
+{
+	PREDICT_ANGLE = 0,		//azimuth atan2(By, Bx) as binary angle
+	PREDICT_X = 1,
+	PREDICT_Y = 2,
+	PREDICT_Z = 3
+};
+
+typedef struct
+{
+	int16_t value;			//value at the time of the sample
+	int64_t velocity;		//per us in Q32
+	int64_t acceleration;	//per us^2 in Q32
+} PredictorChannel_t;
+
+typedef struct
+{
+	uint32_t time;			//time of the acquisition in us
+	PredictorChannel_t channel[4];
+} PredictorModel_t;
+
+/**
+ * Extrapolation of the azimuth and the field between samples, e.g. for a control loop running faster than the sensor.
+ * The model is fitted when a sample is added; a query only takes a consistent copy of the model and evaluates a
+ * polynomial in integer math. The model is double buffered, so queries are safe from an interrupt of any priority
+ * relative to addToPredictor(); a query interrupted by addToPredictor() twice is repeated.
+ */
+typedef struct
+{
+	PredictorModel_t model[2];
+	volatile uint8_t sequence;		//model[sequence & 1] is the current one
+	uint8_t order;
+	uint8_t count;					//samples in the history, at most 2
+	uint32_t latency;				//time from the acquisition to the timestamp of a sample in us
+	uint32_t maxHorizon;			//largest extrapolation in us
+	uint32_t historyTime[2];		//older samples, [1] is the newest
+	int16_t history[2][4];
+} Predictor_t;
+
+/**
+ * @param order @ref PredictorOrder_e
+ * @param latency Time from the acquisition to the timestamp passed to addToPredictor() in us, e.g. the conversion
+ * 		  time plus the read-out when the timestamp is taken after updateData()
+ * @param maxHorizon Extrapolation is limited to this time after the acquisition in us, e.g. twice the sample interval,
+ * 		  so the prediction does not run away when samples stop
+ */
+void initPredictor(Predictor_t *predictor, uint8_t order, uint32_t latency, uint32_t maxHorizon);
+
+/**
+ * @brief Adds a sample and fits the model; one 64 bit division per channel and order
+ * @param time Timestamp in us, e.g. micros() after updateData()
+ * @param x, y, z Raw field in LSB
+ */
+void addToPredictor(Predictor_t *predictor, uint32_t time, int16_t x, int16_t y, int16_t z);
+
+/**
+ * @brief Predicts the azimuth at a time; O(1), no division
+ * @param time Time in us, e.g. micros()
+ * @return the azimuth as binary angle; 0 before the first sample
+ */
+Bam_t predictAngle(const Predictor_t *predictor, uint32_t time);
+
+/**
+ * @brief Predicts the field at a time; O(1), no division
+ * @param time Time in us, e.g. micros()
+ * @param x, y, z Return the field in LSB [-2048,2047]
+ * @return false before the first sample
+ */
+bool predictField(const Predictor_t *predictor, uint32_t time, int16_t *x, int16_t *y, int16_t *z);
+
+}
+
+#endif
@@ -0,0 +1,193 @@
+#include "Resampler.h"
+
+using tli493d::Resampler_t;
+
+//index of the i-th oldest buffered sample
+static uint8_t ringIndex(const Resampler_t *resampler, uint8_t i)
+{
+	return (resampler->newest + TLI493D_RESAMPLER_SIZE + 1 - resampler->count + i) % TLI493D_RESAMPLER_SIZE;
+}
+
+//signed difference of two timestamps, valid across the overflow of micros()
+static int32_t timeDiff(uint32_t a, uint32_t b)
+{
+	return (int32_t)(a - b);
+}
+
+static bool due(const Resampler_t *resampler, uint32_t now)
+{
+	if (resampler->count == 0)
+		return false;
+	if (timeDiff(now, resampler->nextTime) >= (int32_t)resampler->maxLatency)
+		return true;
+	//samples at or after the output time: one for linear, two for cubic
+	uint8_t after = 0;
+	for (uint8_t i = 0; i < resampler->count; i++)
+	{
+		if (timeDiff(resampler->time[ringIndex(resampler, i)], resampler->nextTime) >= 0)
+			after++;
+	}
+	return after > resampler->mode;
+}
+
+//Hermite slope of a sample from its neighbours in Q16 LSB/us, 12 bit values keep the numerator in 32 bits
+static void setSlope(Resampler_t *resampler, uint8_t i, uint8_t previous, uint8_t next)
+{
+	int32_t dt = (int32_t)(resampler->time[next] - resampler->time[previous]);
+	for (uint8_t c = 0; c < 3; c++)
+		resampler->slope[i][c] = ((int32_t)(resampler->value[next][c] - resampler->value[previous][c]) << 16) / dt;
+	resampler->slopes |= 1 << i;
+}
+
+//tangent of a sample over the interval h in Q16 units of the value per h, one-sided without a slope
+static int64_t hermiteTangent(const Resampler_t *resampler, uint8_t i, uint8_t c, int16_t v0, int16_t v1, uint32_t h)
+{
+	if (resampler->slopes & (1 << i))
+		return (int64_t)resampler->slope[i][c] * h;
+	return (int64_t)(v1 - v0) << 16;
+}
+
+static void produce(Resampler_t *resampler, int16_t (&out)[3])
+{
+	uint32_t t = resampler->nextTime;
+	resampler->nextTime += resampler->period;
+
+	//segment with time[k] < t <= time[k + 1]
+	int8_t k = -1;
+	for (uint8_t i = 0; i + 1 < resampler->count; i++)
+	{
+		if (timeDiff(t, resampler->time[ringIndex(resampler, i)]) > 0 &&
+			timeDiff(t, resampler->time[ringIndex(resampler, i + 1)]) <= 0)
+		{
+			k = i;
+			break;
+		}
+	}
+
+	if (k < 0)
+	{
+		//before the first or after the last sample: hold the nearest one
+		uint8_t i = timeDiff(t, resampler->time[ringIndex(resampler, 0)]) <= 0 ? ringIndex(resampler, 0) : resampler->newest;
+		for (uint8_t c = 0; c < 3; c++)
+			out[c] = resampler->value[i][c];
+		return;
+	}
+
+	uint8_t i0 = ringIndex(resampler, k);
+	uint8_t i1 = ringIndex(resampler, k + 1);
+	uint32_t h = resampler->time[i1] - resampler->time[i0];
+	uint32_t dt = t - resampler->time[i0];
+	//position in the segment in Q16, intervals of 65.5ms and more are reduced to 16 bits for a 32 bit division
+	uint8_t shift = 0;
+	while ((h >> shift) > 0xFFFF)
+		shift++;
+	int32_t f = (int32_t)(((dt >> shift) << 16) / (h >> shift));
+	bool cubic = resampler->mode == tli493d::RESAMPLE_CUBIC;
+
+	for (uint8_t c = 0; c < 3; c++)
+	{
+		int16_t v0 = resampler->value[i0][c];
+		int16_t v1 = resampler->value[i1][c];
+		int64_t value;
+		if (!cubic)
+		{
+			value = ((int64_t)v0 << 16) + ((int64_t)(v1 - v0) * f);
+		}
+		else
+		{
+			//slopes from the neighbours, one-sided at the ends of the buffer
+			int64_t m0 = hermiteTangent(resampler, i0, c, v0, v1, h);
+			int64_t m1 = hermiteTangent(resampler, i1, c, v0, v1, h);
+			//Hermite basis in Q16
+			int64_t f2 = ((int64_t)f * f) >> 16;
+			int64_t f3 = (f2 * f) >> 16;
+			int64_t h00 = 2 * f3 - 3 * f2 + 65536;
+			int64_t h10 = f3 - 2 * f2 + f;
+			int64_t h01 = -2 * f3 + 3 * f2;
+			int64_t h11 = f3 - f2;
+			value = h00 * v0 + h01 * v1 + ((h10 * m0 + h11 * m1) >> 16);
+		}
+		value = (value + 0x8000) >> 16;
+		out[c] = constrain(value, -2048, 2047);
+	}
+}
+
+void tli493d::initResampler(Resampler_t *resampler, uint8_t mode, uint32_t period, uint32_t start, uint32_t maxLatency)
+{
+	resampler->newest = 0;
+	resampler->count = 0;
+	resampler->slopes = 0;
+	resampler->mode = mode > RESAMPLE_CUBIC ? (uint8_t)RESAMPLE_CUBIC : mode;
+	resampler->period = period == 0 ? 1 : period;
+	resampler->nextTime = start;
+	resampler->maxLatency = maxLatency;
+}
+
+void tli493d::addToResampler(Resampler_t *resampler, uint32_t time, int16_t x, int16_t y, int16_t z)
+{
+	//samples must be in order
+	if (resampler->count > 0 && timeDiff(time, resampler->time[resampler->newest]) <= 0)
+		return;
+
+	if (resampler->count == 0)
+	{
+		//skip outputs before the first sample, keeping the clock
+		int32_t late = timeDiff(time, resampler->nextTime);
+		if (late > 0)
+			resampler->nextTime += ((uint32_t)late + resampler->period - 1) / resampler->period * resampler->period;
+	}
+	else
+	{
+		resampler->newest = (resampler->newest + 1) % TLI493D_RESAMPLER_SIZE;
+	}
+	resampler->time[resampler->newest] = time;
+	resampler->value[resampler->newest][0] = x;
+	resampler->value[resampler->newest][1] = y;
+	resampler->value[resampler->newest][2] = z;
+	resampler->slopes &= ~(1 << resampler->newest);
+	if (resampler->count < TLI493D_RESAMPLER_SIZE)
+		resampler->count++;
+
+	//the previous sample has both neighbours now
+	if (resampler->mode == RESAMPLE_CUBIC && resampler->count >= 3)
+		setSlope(resampler, ringIndex(resampler, resampler->count - 2), ringIndex(resampler, resampler->count - 3),
+				 resampler->newest);
+}
+
+bool tli493d::getResampled(Resampler_t *resampler, uint32_t now, int16_t (&out)[3], uint32_t *time)
+{
+	if (!due(resampler, now))
+		return false;
+	*time = resampler->nextTime;
+	produce(resampler, out);
+	return true;
+}
+
+bool tli493d::getResampledFrame(Resampler_t *resamplers, uint8_t count, uint32_t now, int16_t (*out)[3], uint32_t *time)
+{
+	if (count == 0)
+		return false;
+
+	//common output time: the latest of all streams
+	uint32_t next = resamplers[0].nextTime;
+	for (uint8_t i = 1; i < count; i++)
+	{
+		if (timeDiff(resamplers[i].nextTime, next) > 0)
+			next = resamplers[i].nextTime;
+	}
+	for (uint8_t i = 0; i < count; i++)
+	{
+		if (timeDiff(next, resamplers[i].nextTime) > 0)
+		{
+			//same period and start: the difference is a multiple of the period
+			resamplers[i].nextTime = next;
+		}
+		if (!due(&resamplers[i], now))
+			return false;
+	}
+
+	*time = next;
+	for (uint8_t i = 0; i < count; i++)
+		produce(&resamplers[i], out[i]);
+	return true;
+}
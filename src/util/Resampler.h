@@ -0,0 +1,72 @@
+#ifndef TLI493D_RESAMPLER_H_INCLUDED
+#define TLI493D_RESAMPLER_H_INCLUDED
+
+#include <Arduino.h>
+
+#define TLI493D_RESAMPLER_SIZE		4	//buffered samples: enough for cubic interpolation when outputs are taken after each sample
+
+namespace tli493d
+{
+
+enum ResamplerMode_e
+{
+	RESAMPLE_LINEAR = 0,
+	RESAMPLE_CUBIC = 1		//cubic Hermite with slopes from the neighbouring samples, waits for one more sample;
+							//the slopes are computed once per sample with three divisions
+};
+
+/**
+ * Resampling of Bx, By and Bz from irregular timestamps, e.g. interrupts in wake-up or low power mode, to a uniform
+ * output clock. An output is produced when the samples around it are available, or at the latest maxLatency after
+ * its time with the last value. In wake-up mode no samples arrive while the field stays inside the window, so holding
+ * the last value is correct within the window. Streams of several sensors with the same period and start time share
+ * the output clock, see getResampledFrame().
+ */
+typedef struct
+{
+	uint32_t time[TLI493D_RESAMPLER_SIZE];
+	int16_t value[TLI493D_RESAMPLER_SIZE][3];
+	int32_t slope[TLI493D_RESAMPLER_SIZE][3];	//Hermite slope of a sample in Q16 LSB/us, set when its successor arrives
+	uint8_t slopes;			//bit i: slope[i] is valid
+	uint8_t newest;			//index of the newest sample
+	uint8_t count;			//buffered samples
+	uint8_t mode;			//@ref ResamplerMode_e
+	uint32_t period;		//output interval in us
+	uint32_t nextTime;		//time of the next output in us
+	uint32_t maxLatency;	//largest delay of an output after its time in us
+} Resampler_t;
+
+/**
+ * @param period Output interval in us
+ * @param start Time of the first output in us; outputs before the first sample are skipped on the same clock
+ * @param maxLatency Largest delay of an output in us, at least the largest expected sample interval (two for cubic)
+ */
+void initResampler(Resampler_t *resampler, uint8_t mode, uint32_t period, uint32_t start, uint32_t maxLatency);
+
+/**
+ * @brief Adds a sample; take all available outputs with getResampled() before adding the next one
+ * @param time Time of the sample in us, e.g. micros() in the interrupt
+ * @param x,y,z Field in LSB [-2048,2047]
+ */
+void addToResampler(Resampler_t *resampler, uint32_t time, int16_t x, int16_t y, int16_t z);
+
+/**
+ * @brief Returns the next output if it is due. Call it until it returns false.
+ * @param now Current time in us, for the latency bound
+ * @param out Returns Bx, By and Bz in LSB
+ * @param time Returns the time of the output in us
+ * @return true if an output was returned
+ */
+bool getResampled(Resampler_t *resampler, uint32_t now, int16_t (&out)[3], uint32_t *time);
+
+/**
+ * @brief Returns the next output of several streams on a common clock, only when it is due for all of them.
+ * 		  Streams that start later skip the outputs the others have already passed.
+ * @param out Returns Bx, By and Bz of each stream
+ * @return true if an output was returned
+ */
+bool getResampledFrame(Resampler_t *resamplers, uint8_t count, uint32_t now, int16_t (*out)[3], uint32_t *time);
+
+}
+
+#endif
@@ -0,0 +1,90 @@
+#include "Rpm.h"
+
+//averages unsigned intervals, the first value is taken as is
+static uint32_t average(uint32_t old, uint32_t value, uint8_t shift)
+{
+	if (old == 0)
+		return value;
+	if (value >= old)
+		return old + ((value - old) >> shift);
+	return old - ((old - value) >> shift);
+}
+
+void tli493d::initRpm(Rpm_t *rpm, int16_t level, int16_t hysteresis, uint8_t polePairs, uint8_t averageShift)
+{
+	rpm->level = level;
+	rpm->hysteresis = hysteresis;
+	rpm->polePairs = polePairs == 0 ? 1 : polePairs;
+	rpm->averageShift = averageShift;
+	rpm->armed = false;
+	rpm->belowValid = false;
+	rpm->aboveValid = false;
+	rpm->crossingValid = false;
+	rpm->aliasing = false;
+	rpm->lastSample = 0;
+	rpm->sampleInterval = 0;
+	rpm->period = 0;
+}
+
+bool tli493d::addToRpm(Rpm_t *rpm, uint32_t time, int16_t value)
+{
+	int16_t v = value - rpm->level;
+
+	if (rpm->lastSample != 0)
+		rpm->sampleInterval = average(rpm->sampleInterval, time - rpm->lastSample, rpm->averageShift);
+	rpm->lastSample = time;
+
+	//no crossing within four periods: stopped or much slower
+	if (rpm->crossingValid && time - rpm->lastCrossing > (rpm->period << 2) && rpm->period != 0)
+	{
+		rpm->crossingValid = false;
+		rpm->period = 0;
+	}
+
+	if (v < 0)
+	{
+		rpm->below = v;
+		rpm->belowTime = time;
+		rpm->belowValid = true;
+		rpm->aboveValid = false;
+		if (v <= -rpm->hysteresis)
+			rpm->armed = true;
+		return false;
+	}
+	if (!rpm->aboveValid)
+	{
+		rpm->above = v;
+		rpm->aboveTime = time;
+		rpm->aboveValid = true;
+	}
+	if (!rpm->armed || !rpm->belowValid || v < rpm->hysteresis)
+		return false;
+
+	//crossing between the last sample below and the first sample above the level
+	rpm->armed = false;
+	uint32_t dt = rpm->aboveTime - rpm->belowTime;
+	uint32_t crossing = rpm->belowTime;
+	if (dt < (1UL << 20))	//keeps dt * 2^12 in 32 bit
+		crossing += dt * (uint32_t)(-rpm->below) / (uint32_t)(rpm->above - rpm->below);
+	else
+		crossing += dt >> 1;
+
+	if (rpm->crossingValid)
+		rpm->period = average(rpm->period, crossing - rpm->lastCrossing, rpm->averageShift);
+	rpm->lastCrossing = crossing;
+	rpm->crossingValid = true;
+	rpm->aliasing = rpm->period != 0 && rpm->period < TLI493D_RPM_MIN_SAMPLES * rpm->sampleInterval;
+	return true;
+}
+
+uint32_t tli493d::getRpm(const Rpm_t *rpm)
+{
+	if (rpm->period == 0)
+		return 0;
+	return 60000000UL / (rpm->period * rpm->polePairs);
+}
+
+bool tli493d::rpmAliasing(const Rpm_t *rpm)
+{
+	return rpm->aliasing;
+}
@@ -0,0 +1,58 @@
+#ifndef TLI493D_RPM_H_INCLUDED
+#define TLI493D_RPM_H_INCLUDED
+
+#include <Arduino.h>
+
+#define TLI493D_RPM_MIN_SAMPLES		4	//samples per signal period below which aliasing is reported (Nyquist: 2)
+
+namespace tli493d
+{
+
+/**
+ * Speed measurement from the rising crossings of one field axis through a level. The crossing time is interpolated
+ * linearly between the samples around the level, so the resolution is better than the sample interval.
+ */
+typedef struct
+{
+	int16_t level;				//crossing level in LSB, e.g. the offset of the axis
+	int16_t hysteresis;			//LSB below and above the level needed to detect a crossing
+	uint8_t polePairs;			//signal periods per revolution
+	uint8_t averageShift;		//averaging of the period: new = old + (period - old) / 2^averageShift
+	bool armed;					//signal was below level - hysteresis
+	bool belowValid;
+	bool aboveValid;
+	bool crossingValid;
+	bool aliasing;
+	int16_t below;				//last sample below the level
+	int16_t above;				//first sample at or above the level after it
+	uint32_t belowTime;
+	uint32_t aboveTime;
+	uint32_t lastCrossing;
+	uint32_t lastSample;
+	uint32_t sampleInterval;	//averaged time between samples in us
+	uint32_t period;			//averaged signal period in us, 0 if unknown or stopped
+} Rpm_t;
+
+void initRpm(Rpm_t *rpm, int16_t level, int16_t hysteresis, uint8_t polePairs, uint8_t averageShift);
+
+/**
+ * @brief Adds a sample. Only integer compares, except one division per detected crossing.
+ * @param time Time of the sample in us, e.g. micros()
+ * @param value Field of the chosen axis in LSB
+ * @return true if a crossing was detected
+ */
+bool addToRpm(Rpm_t *rpm, uint32_t time, int16_t value);
+
+/**
+ * @return revolutions per minute, 0 if unknown or stopped
+ */
+uint32_t getRpm(const Rpm_t *rpm);
+
+/**
+ * @return true if the rotation is too fast for the sample rate, i.e. less than TLI493D_RPM_MIN_SAMPLES samples per signal period
+ */
+bool rpmAliasing(const Rpm_t *rpm);
+
+}
+
+#endif
@@ -0,0 +1,134 @@
+#include "Spectrum.h"
+#include "IntMath.h"
+#include <math.h>
+
+void tli493d::initGoertzel(Goertzel_t *goertzel, float frequency, float sampleRate)
+{
+	float coeff = 2.0 * cos(2.0 * M_PI * frequency / sampleRate) * (1 << 14);
+	goertzel->coeff = (int16_t)constrain(coeff, -32768.0, 32767.0);
+	goertzel->count = 0;
+	goertzel->s1 = 0;
+	goertzel->s2 = 0;
+}
+
+void tli493d::addToGoertzel(Goertzel_t *bank, uint8_t count, int16_t sample)
+{
+	for (uint8_t i = 0; i < count; i++)
+	{
+		Goertzel_t *g = &bank[i];
+		int32_t s0 = sample + (int32_t)(((int64_t)g->coeff * g->s1) >> 14) - g->s2;
+		g->s2 = g->s1;
+		g->s1 = s0;
+		g->count++;
+	}
+}
+
+uint16_t tli493d::getGoertzelAmplitude(Goertzel_t *goertzel)
+{
+	int64_t power = (int64_t)goertzel->s1 * goertzel->s1 + (int64_t)goertzel->s2 * goertzel->s2 -
+					(((int64_t)goertzel->coeff * goertzel->s1 >> 14) * goertzel->s2);
+	uint32_t n = goertzel->count;
+	uint16_t amplitude = 0;
+
+	//amplitude = 2 * sqrt(power) / N
+	if (n != 0 && power > 0)
+	{
+		int64_t squared = power * 4 / ((int64_t)n * n);
+		amplitude = sqrtInt(squared > 0xFFFFFFFFLL ? 0xFFFFFFFFUL : (uint32_t)squared);
+	}
+	goertzel->count = 0;
+	goertzel->s1 = 0;
+	goertzel->s2 = 0;
+	return amplitude;
+}
+
+void tli493d::applyHannWindow(int16_t *data, uint8_t log2n)
+{
+	uint8_t step = 1 << (TLI493D_FFT_MAX_LOG2 - log2n);
+	uint16_t n = 1 << log2n;
+
+	for (uint16_t i = 0; i < n; i++)
+	{
+		//w = (1 - cos(2*pi*i/N)) / 2 in Q15
+		int32_t w = ((int32_t)TLI493D_Q15_ONE - cosInt(i * step)) >> 1;
+		data[i] = (int16_t)(((int32_t)data[i] * w) >> 15);
+	}
+}
+
+static int16_t saturate(int32_t value)
+{
+	return (int16_t)constrain(value, (int32_t)INT16_MIN, (int32_t)INT16_MAX);
+}
+
+void tli493d::fft(int16_t *re, int16_t *im, uint8_t log2n)
+{
+	uint16_t n = 1 << log2n;
+	uint16_t i, j;
+
+	//bit reversed order
+	for (i = 1, j = 0; i < n; i++)
+	{
+		uint16_t bit = n >> 1;
+		for (; j & bit; bit >>= 1)
+			j ^= bit;
+		j ^= bit;
+		if (i < j)
+		{
+			int16_t t = re[i]; re[i] = re[j]; re[j] = t;
+			t = im[i]; im[i] = im[j]; im[j] = t;
+		}
+	}
+
+	for (uint8_t stage = 1; stage <= log2n; stage++)
+	{
+		uint16_t half = 1 << (stage - 1);
+		uint8_t step = 1 << (TLI493D_FFT_MAX_LOG2 - stage);
+		for (uint16_t k = 0; k < half; k++)
+		{
+			//twiddle factor exp(-2*pi*i*k/len)
+			int32_t wr = cosInt(k * step);
+			int32_t wi = -sinInt(k * step);
+			for (i = k; i < n; i += 2 * half)
+			{
+				j = i + half;
+				int32_t tr = (wr * re[j] - wi * im[j]) >> 15;
+				int32_t ti = (wr * im[j] + wi * re[j]) >> 15;
+				//the halving keeps the magnitude below 32768, but not each component of a larger complex input
+				re[j] = saturate((re[i] - tr) >> 1);
+				im[j] = saturate((im[i] - ti) >> 1);
+				re[i] = saturate((re[i] + tr) >> 1);
+				im[i] = saturate((im[i] + ti) >> 1);
+			}
+		}
+	}
+}
+
+uint16_t tli493d::getBandMagnitude(const int16_t *re, const int16_t *im, uint16_t firstBin, uint16_t lastBin)
+{
+	uint32_t sum = 0;
+	for (uint16_t i = firstBin; i <= lastBin; i++)
+	{
+		uint32_t squared = (uint32_t)((int32_t)re[i] * re[i]) + (uint32_t)((int32_t)im[i] * im[i]);
+		sum = (sum + squared < sum) ? 0xFFFFFFFFUL : sum + squared;
+	}
+	return sqrtInt(sum);
+}
+
+uint16_t tli493d::getDominantBin(const int16_t *re, const int16_t *im, uint8_t log2n, uint16_t *magnitude)
+{
+	uint16_t best = 1;
+	uint32_t bestSquared = 0;
+
+	for (uint16_t i = 1; i <= (1 << (log2n - 1)); i++)
+	{
+		uint32_t squared = (uint32_t)((int32_t)re[i] * re[i]) + (uint32_t)((int32_t)im[i] * im[i]);
+		if (squared > bestSquared)
+		{
+			bestSquared = squared;
+			best = i;
+		}
+	}
+	if (magnitude != NULL)
+		*magnitude = sqrtInt(bestSquared);
+	return best;
+}
@@ -0,0 +1,72 @@
+#ifndef TLI493D_SPECTRUM_H_INCLUDED
+#define TLI493D_SPECTRUM_H_INCLUDED
+
+#include <Arduino.h>
+
+#define TLI493D_FFT_MAX_LOG2	8	//largest FFT: 256 points, limited by the resolution of the sine table
+
+namespace tli493d
+{
+
+/**
+ * Goertzel filter for the amplitude of a single frequency in a block of samples.
+ */
+typedef struct
+{
+	int16_t coeff;		//2*cos(2*pi*f/fs) in Q14
+	uint16_t count;		//samples in the current block
+	int32_t s1;
+	int32_t s2;
+} Goertzel_t;
+
+/**
+ * @brief Initializes a Goertzel filter
+ * @param frequency Target frequency in the same unit as sampleRate
+ * @param sampleRate Sample rate, the target frequency has to be below sampleRate/2
+ */
+void initGoertzel(Goertzel_t *goertzel, float frequency, float sampleRate);
+
+/**
+ * @brief Adds one sample in LSB to each filter of a bank
+ */
+void addToGoertzel(Goertzel_t *bank, uint8_t count, int16_t sample);
+
+/**
+ * @brief Finishes the block of a filter and starts the next one
+ * @return the amplitude of the target frequency in LSB
+ */
+uint16_t getGoertzelAmplitude(Goertzel_t *goertzel);
+
+/**
+ * @brief Applies a Hann window to a block of samples in place
+ * @param log2n Block size as power of two [1,TLI493D_FFT_MAX_LOG2]
+ */
+void applyHannWindow(int16_t *data, uint8_t log2n);
+
+/**
+ * @brief Radix-2 FFT in fixed point, in place. Each stage scales by 1/2 to avoid overflow, so the result is scaled by 1/N:
+ * 		  a sine with amplitude A gives a magnitude of A/2 in its bin (A/4 with Hann window).
+ * 		  The magnitude of each complex input value must stay below 32768, which real samples always do. Larger values,
+ * 		  e.g. both parts near full scale, saturate instead of wrapping around.
+ * @param re Real part, the samples in LSB
+ * @param im Imaginary part, zero for samples
+ * @param log2n Block size as power of two [1,TLI493D_FFT_MAX_LOG2]
+ */
+void fft(int16_t *re, int16_t *im, uint8_t log2n);
+
+/**
+ * @brief Combined magnitude of the bins firstBin to lastBin, sqrt of the sum of the squared magnitudes
+ */
+uint16_t getBandMagnitude(const int16_t *re, const int16_t *im, uint16_t firstBin, uint16_t lastBin);
+
+/**
+ * @brief Finds the bin with the largest magnitude in the range 1 to N/2, ignoring the DC bin.
+ * 		  Its frequency is bin * sampleRate / N.
+ * @param magnitude Returns the magnitude of the bin; may be NULL
+ * @return the index of the bin
+ */
+uint16_t getDominantBin(const int16_t *re, const int16_t *im, uint8_t log2n, uint16_t *magnitude);
+
+}
+
+#endif
@@ -0,0 +1,92 @@
+#include "Statistics.h"
+
+void tli493d::initWelford(Welford_t *welford)
+{
+	welford->count = 0;
+	welford->mean = 0;
+	welford->m2 = 0;
+}
+
+void tli493d::addToWelford(Welford_t *welford, int16_t value)
+{
+	int32_t x = (int32_t)value << TLI493D_WELFORD_MEAN_SHIFT;
+	int32_t delta = x - welford->mean;
+	int32_t count;
+
+	if (welford->count == 0xFFFFFFFFUL)
+		return;
+	welford->count++;
+	count = welford->count > 0x7FFFFFFFUL ? 0x7FFFFFFFL : (int32_t)welford->count;
+	//round to nearest, truncation would bias the mean towards zero
+	if (delta >= 0)
+		welford->mean += (delta + (count >> 1)) / count;
+	else
+		welford->mean += (delta - (count >> 1)) / count;
+	welford->m2 += ((int64_t)delta * (x - welford->mean)) >> (2 * TLI493D_WELFORD_MEAN_SHIFT - TLI493D_WELFORD_VAR_SHIFT);
+}
+
+int16_t tli493d::getWelfordMean(const Welford_t *welford)
+{
+	int32_t half = 1L << (TLI493D_WELFORD_MEAN_SHIFT - 1);
+	return (int16_t)((welford->mean + half) >> TLI493D_WELFORD_MEAN_SHIFT);
+}
+
+uint32_t tli493d::getWelfordVariance(const Welford_t *welford)
+{
+	//rounding of the mean can make m2 slightly negative for constant input
+	if (welford->count < 2 || welford->m2 <= 0)
+		return 0;
+	int64_t variance = welford->m2 / (int64_t)(welford->count - 1);
+	return variance > 0xFFFFFFFFLL ? 0xFFFFFFFFUL : (uint32_t)variance;
+}
+
+void tli493d::initStatistics(Statistics_t *stats)
+{
+	for (uint8_t i = 0; i < STAT_NUM_CHANNELS; i++)
+	{
+		stats->channel[i].histLow = 0;
+		stats->channel[i].histShift = TLI493D_HIST_OFF;
+	}
+	resetStatistics(stats);
+}
+
+void tli493d::resetStatistics(Statistics_t *stats)
+{
+	for (uint8_t i = 0; i < STAT_NUM_CHANNELS; i++)
+	{
+		ChannelStatistics_t *channel = &stats->channel[i];
+		initWelford(&channel->welford);
+		channel->min = INT16_MAX;
+		channel->max = INT16_MIN;
+		for (uint8_t j = 0; j < TLI493D_HIST_BINS; j++)
+			channel->histogram[j] = 0;
+	}
+}
+
+void tli493d::setHistogram(ChannelStatistics_t *channel, int16_t low, uint8_t shift)
+{
+	//the bin is computed with a shift of an int32_t
+	if (shift != TLI493D_HIST_OFF && shift > 31)
+		shift = 31;
+	channel->histLow = low;
+	channel->histShift = shift;
+	for (uint8_t j = 0; j < TLI493D_HIST_BINS; j++)
+		channel->histogram[j] = 0;
+}
+
+void tli493d::addToStatistics(ChannelStatistics_t *channel, int16_t value)
+{
+	addToWelford(&channel->welford, value);
+	if (value < channel->min)
+		channel->min = value;
+	if (value > channel->max)
+		channel->max = value;
+
+	if (channel->histShift != TLI493D_HIST_OFF)
+	{
+		int32_t bin = ((int32_t)value - channel->histLow) >> channel->histShift;
+		bin = constrain(bin, 0, TLI493D_HIST_BINS - 1);
+		if (channel->histogram[bin] < 0xFFFF)
+			channel->histogram[bin]++;
+	}
+}
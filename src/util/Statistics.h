@@ -0,0 +1,89 @@
+#ifndef TLI493D_STATISTICS_H_INCLUDED
+#define TLI493D_STATISTICS_H_INCLUDED
+
+#include <Arduino.h>
+
+#define TLI493D_WELFORD_MEAN_SHIFT	16		//fractional bits of the mean
+#define TLI493D_WELFORD_VAR_SHIFT	8		//fractional bits of the sum of squared deviations and the variance
+#define TLI493D_HIST_BINS			8
+#define TLI493D_HIST_OFF			0xFF	//histogram shift value which disables the histogram
+
+namespace tli493d
+{
+
+enum StatChannel_e
+{
+	STAT_X = 0,
+	STAT_Y,
+	STAT_Z,
+	STAT_TEMP,
+	STAT_NUM_CHANNELS
+};
+
+/**
+ * Online mean and variance after Welford in fixed point, see TLI493D_WELFORD_MEAN_SHIFT and TLI493D_WELFORD_VAR_SHIFT.
+ */
+typedef struct
+{
+	uint32_t count;
+	int32_t mean;
+	int64_t m2;
+} Welford_t;
+
+/**
+ * Statistics of one channel. The histogram has TLI493D_HIST_BINS bins of width 2^histShift starting at histLow,
+ * values outside are counted in the first or last bin.
+ */
+typedef struct
+{
+	Welford_t welford;
+	int16_t min;
+	int16_t max;
+	int16_t histLow;
+	uint8_t histShift;
+	uint16_t histogram[TLI493D_HIST_BINS];
+} ChannelStatistics_t;
+
+typedef struct
+{
+	ChannelStatistics_t channel[STAT_NUM_CHANNELS];
+} Statistics_t;
+
+void initWelford(Welford_t *welford);
+void addToWelford(Welford_t *welford, int16_t value);
+
+/**
+ * @return the mean in LSB, rounded
+ */
+int16_t getWelfordMean(const Welford_t *welford);
+
+/**
+ * @return the sample variance in LSB^2 with TLI493D_WELFORD_VAR_SHIFT fractional bits
+ */
+uint32_t getWelfordVariance(const Welford_t *welford);
+
+/**
+ * @brief Clears all channels and disables their histograms
+ */
+void initStatistics(Statistics_t *stats);
+
+/**
+ * @brief Clears the counters of all channels; the histogram configuration is kept
+ */
+void resetStatistics(Statistics_t *stats);
+
+/**
+ * @brief Enables the histogram of a channel and clears it
+ * @param low Lower bound of the first bin
+ * @param shift Bin width as power of two, at most 31; TLI493D_HIST_OFF disables the histogram
+ */
+void setHistogram(ChannelStatistics_t *channel, int16_t low, uint8_t shift);
+
+/**
+ * @brief Adds a sample to a channel; O(1) without buffers
+ */
+void addToStatistics(ChannelStatistics_t *channel, int16_t value);
+
+}
+
+#endif
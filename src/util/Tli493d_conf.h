@@ -16,12 +16,29 @@
 #define TLI493D_STARTUPDELAY		60
 #define TLI493D_RESETDELAY			30
 
+//bus recovery: consecutive failed transfers before the bus is considered stuck
+#define TLI493D_MAX_BUS_ERRORS		3
+#define TLI493D_RECOVERY_CLOCKS		9	//clock pulses to release SDA held by the sensor
+#define TLI493D_RECOVERY_HALFCLOCK	5	//us, half period of the recovery clock (100kHz)
+#define TLI493D_READ_TIMEOUT		5000	//us, deadline of a read, 23 bytes at 100kHz and clock stretching
+#define TLI493D_WRITE_TIMEOUT		3000	//us, deadline of a write, burst of 10 registers at 100kHz
+
 #define TLI493D_NUM_OF_REGMASKS		51
 #define TLI493D_NUM_OF_ACCMODES		4
 #define TLI493D_MSB_MASK			0x07F8
 #define TLI493D_LSB_MASK			0x0007
 #define TLI493D_MAX_WU_THR			2048
+#define TLI493D_WU_BURST			10	 //registers XL (07h) to CONFIG (10h) including CP
+#define TLI493D_CONFIG_BURST		11	 //registers XL (07h) to MOD1 (11h), the first transfer of the configuration
+#define TLI493D_CONFIG_TAIL			2	 //registers MOD2 (13h) and CONFIG2 (14h), the second transfer
+#define TLI493D_CONFIG_CHUNKS		13	 //single register writes of writeConfig(): MOD1, XL to CONFIG, MOD2, CONFIG2
+
+//wake-up auto tuning
+#define TLI493D_TUNE_SAMPLES		64	 //default number of samples taken at rest
+#define TLI493D_TUNE_MARGIN			3	 //LSB added to the window: threshold resolution (2 LSB) and mean error
+#define TLI493D_TUNE_TEMP_DELTA		42	 //temperature change in LSB (about 10 degree celsius) after which to re-tune
 #define TLI493D_MEASUREMENT_READOUT	7
+#define TLI493D_SOFTWU_READOUT		6	 //Bx, By, Bz and their LSBs without diagnosis
 
 #define TLI493D_B_MULT_FULL			1.0/7.7
 #define TLI493D_B_MULT_X2			1.0/15.4
@@ -32,6 +49,23 @@
 #define TLI493D_TEMP_OFFSET 		1180 //range 1000 to 1360
 #define TLI493D_TEMP_25				25 	 //room temperature offset
 
+//self test
+#define TLI493D_SELFTEST_MIN_LSB	64	 //minimum field in full range to check the X2/X4 scaling
+#define TLI493D_SELFTEST_NOISE		3	 //allowed deviation of the scaling in LSB on top of 25%
+#define TLI493D_SELFTEST_TEMP_MIN	-40	 //plausible junction temperature in degree celsius
+#define TLI493D_SELFTEST_TEMP_MAX	125
+
+//gradiometric sensor pair
+#define TLI493D_PAIR_STRAY_LIMIT	2.0	 //default bound of the stray field in mT
+#define TLI493D_PAIR_RATIO			-1.0 //default field ratio second/first sensor: opposite fields of equal size
+#define TLI493D_PAIR_MAX_RATIO		0.8	 //above this ratio the difference is too small to reject stray fields
+#define TLI493D_PAIR_CAL_SAMPLES	16	 //default number of samples for the calibration of the ratio
+
+//discovery
+#define TLI493D_NUM_TYPES			4	 //addresses A0 to A3 per bus
+#define TLI493D_VERSION_MASK		0x0F	 //lower nibble of the version register is the same for all versions
+#define TLI493D_VERSION_LOW			0x09
+
 namespace tli493d
 {
 /**
@@ -74,7 +108,8 @@ enum RegisterAddr_e
 	CONFIG_REGISTER = 0x10,
 	MOD1_REGISTER = 0x11,
 	MOD2_REGISTER = 0x13,
-	CONFIG2_REGISTER = 0x14
+	CONFIG2_REGISTER = 0x14,
+	VERSION_REGISTER = 0x16
 };
 
 const RegMask_t regMasks[] = {